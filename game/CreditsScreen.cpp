@@ -1,21 +1,13 @@
 #include "CreditsScreen.h"
 #include <cmath>
+#include "src/graphics/GlyphWarmup.h"
 
-CreditsScreen::CreditsScreen(ResourceManager& res, Vector2u winSize) {
-    background.setSize(Vector2f(winSize));
-    background.setFillColor(Color(34, 3, 12));
-	//Carga titulo
-    font = &res.getFont("assets/fonts/default.ttf");
-    titleFont = &res.getFont("assets/fonts/title.ttf");
-	title.setFont(*titleFont);
-	title.setString("CREDITOS");
-	title.setCharacterSize(120);
-	title.setFillColor(Color(252, 244, 228));
-	FloatRect bounds = title.getLocalBounds();
-	title.setOrigin(bounds.left + bounds.width / 2.f,bounds.top  + bounds.height / 2.f);
-	title.setPosition(winSize.x / 2.f, 120.f);
-	//String mostrado
-    vector<string> content = {
+namespace {
+const char* const TitleLabel = "CREDITOS";
+const char* const HintLabel = "Presiona cualquier tecla o click para volver";
+
+vector<string> creditsLines() {
+    return {
         "Visualnovel desarrollado por:",
         "KitllyCat",
         "Matoricore",
@@ -31,17 +23,45 @@ CreditsScreen::CreditsScreen(ResourceManager& res, Vector2u winSize) {
         "Al encargado de sprites y graficos, al creador de la historia y a todos los que apoyaron este proyecto...",
         "Gracias por jugar Remoria~... <3"
     };
+}
+}
+
+CreditsScreen::CreditsScreen(ResourceManager& res, Vector2u winSize) {
+    background.setSize(Vector2f(winSize));
+    background.setFillColor(Color(34, 3, 12));
+	//Carga titulo
+    font = &res.getFont("assets/fonts/default.ttf");
+    titleFont = &res.getFont("assets/fonts/title.ttf");
+	title.setFont(*titleFont);
+	title.setString(TitleLabel);
+	title.setCharacterSize(120);
+	title.setFillColor(Color(252, 244, 228));
+	GlyphWarmup::getInstance().checkText(title);
+	FloatRect bounds = title.getLocalBounds();
+	title.setOrigin(bounds.left + bounds.width / 2.f,bounds.top  + bounds.height / 2.f);
+	title.setPosition(winSize.x / 2.f, 120.f);
+	//String mostrado
+    vector<string> content = creditsLines();
+    glyphAtlas = res.findGlyphAtlas(ResourceId::of("assets/fonts/default.ttf"));
+    if (glyphAtlas && !glyphAtlas->hasSize(32)){glyphAtlas = nullptr;}
     float y = 300.f;
     for (auto& s : content) {
-        Text t(s, *font, 32);
-        t.setFillColor(Color(200, 200, 220));
-        t.setPosition(winSize.x / 2.f - t.getLocalBounds().width / 2, y);
+        if (glyphAtlas) {
+            float width = TextLayout::measure(s, GlyphMetrics::get(*font, 32));
+            TextLayout::buildGlyphRun(s, *glyphAtlas, 32, 1.f, Color(200, 200, 220), linesLayer, Vector2f(winSize.x / 2.f - width / 2, y));
+        } else {
+            Text t(s, *font, 32);
+            t.setFillColor(Color(200, 200, 220));
+            GlyphWarmup::getInstance().checkText(t);
+            t.setPosition(winSize.x / 2.f - t.getLocalBounds().width / 2, y);
+            lines.push_back(t);
+        }
         y += 48;
-        lines.push_back(t);
     }
     hint.setFont(*font);
-    hint.setString("Presiona cualquier tecla o click para volver");
+    hint.setString(HintLabel);
     hint.setCharacterSize(24);
+    GlyphWarmup::getInstance().checkText(hint);
     hint.setFillColor(Color(150, 150, 150));
     hint.setPosition(winSize.x - 500, winSize.y - 60);
 }
@@ -61,9 +81,27 @@ void CreditsScreen::update(float dt) {
 void CreditsScreen::draw(RenderWindow& window) {
     window.draw(background);
     window.draw(title);
+    if (glyphAtlas) {
+        window.draw(linesLayer.vertices.data(), linesLayer.vertices.size(), Triangles, RenderStates(&glyphAtlas->getTexture()));
+    }
     for (auto& l : lines) window.draw(l);
     window.draw(hint);
 }
 
+void CreditsScreen::collectAtlasText(set<Uint32>& out) {
+    for (const auto& line : creditsLines()) {
+        GlyphWarmup::collect(line, out);
+    }
+}
+
+void CreditsScreen::warmGlyphs(ResourceManager& res) {
+    set<Uint32> title;
+    GlyphWarmup::collect(TitleLabel, title);
+    GlyphWarmup::getInstance().warm(res.getFont("assets/fonts/title.ttf"), title, { 120 });
+    set<Uint32> hint;
+    GlyphWarmup::collect(HintLabel, hint);
+    GlyphWarmup::getInstance().warm(res.getFont("assets/fonts/default.ttf"), hint, { 24 });
+}
+
 bool CreditsScreen::backRequested() const { return back; }
 void CreditsScreen::reset() { back = false; }
@@ -1,13 +1,19 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <vector>
+#include <set>
 #include "src/core/ResourceManager.h"
+#include "src/graphics/TextLayout.h"
 using namespace sf;
 using namespace std;
 
 class CreditsScreen {
 public:
     CreditsScreen(ResourceManager& res, Vector2u winSize);
+    //Codepoints de las lineas (se dibujan con el atlas de glifos de default.ttf)
+    static void collectAtlasText(set<Uint32>& out);
+    //Rasteriza titulo y hint, que van con sf::Text
+    static void warmGlyphs(ResourceManager& res);
     void handleEvent(const Event& ev);
     void update(float dt);
     void draw(RenderWindow& window);
@@ -20,6 +26,9 @@ private:
     Font* titleFont;
     Text title;
     vector<Text> lines;
+    //Con atlas de la fuente: todas las lineas en un solo draw
+    const GlyphAtlas* glyphAtlas;
+    GlyphRun linesLayer;
     Text hint;
     bool back = false;
 };
@@ -29,8 +29,8 @@ void IntroScreen::addLogo(const string& imagePath, float displayDuration, const
 void IntroScreen::loadSlideTexture(LogoSlide& slide) {
     if (slide.textureLoaded){return;}
     try {
-        Texture& tex = resources.getTexture(slide.imagePath);
-        slide.sprite.setTexture(tex);
+        slide.texture = resources.acquireTexture(ResourceId::of(slide.imagePath));
+        slide.sprite.setTexture(slide.texture.get());
         //Centrar el sprite
         FloatRect bounds = slide.sprite.getLocalBounds();
         slide.sprite.setOrigin(bounds.width / 2.0f, bounds.height / 2.0f);
@@ -128,6 +128,8 @@ void IntroScreen::handleEvent(const Event& ev) {
 }
 
 void IntroScreen::nextSlide() {
+    slides[currentSlideIndex].texture = TextureHandle();
+    slides[currentSlideIndex].textureLoaded = false;
     currentSlideIndex++;
     if (currentSlideIndex >= slides.size()) {
         currentState = State::FINISHED;
@@ -142,5 +144,13 @@ void IntroScreen::skip() {
     if (skipped) return;
     skipped = true;
     finished = true;
+    releaseSlides();
     cout << "[System] La Introduccion fue omitida!!!" << endl;
 }
+
+void IntroScreen::releaseSlides() {
+    for (auto& slide : slides) {
+        slide.texture = TextureHandle();
+        slide.textureLoaded = false;
+    }
+}
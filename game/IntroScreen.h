@@ -36,6 +36,8 @@ private:
         float displayDuration;
         Color backgroundColor;
         Sprite sprite;
+        //Se suelta al pasar al siguiente: los logos no quedan en memoria despues de la intro
+        TextureHandle texture;
         bool textureLoaded;
     };
 
@@ -55,6 +57,7 @@ private:
     bool skipped;
 
     void loadSlideTexture(LogoSlide& slide);
+    void releaseSlides();
     void nextSlide();
     void skip();
 };
@@ -1,34 +1,57 @@
 #include "MainMenu.h"
 #include "src/save/SaveManager.h"
+#include "src/core/AssetPack.h"
+#include "src/graphics/GlyphWarmup.h"
 using namespace sf;
 
-MainMenu::MainMenu(ResourceManager& res, Vector2u windowSize)
+//Assets del menu: ids calculados una sola vez al iniciar
+namespace {
+const ResourceId MenuBg1 = ResourceId::of("assets/images/menu_bg_1.png");
+const ResourceId MenuBg2 = ResourceId::of("assets/images/menu_bg_2.png");
+const ResourceId Title1 = ResourceId::of("assets/images/ui/title_01.png");
+const ResourceId Title2 = ResourceId::of("assets/images/ui/title_02.png");
+const ResourceId Vignette = ResourceId::of("assets/images/vignette_filter.png");
+const ResourceId TitleFont = ResourceId::of("assets/fonts/title.ttf");
+const ResourceId ButtonSmall = ResourceId::of("assets/images/ui/button_smallx.png");
+const ResourceId ButtonSmallHover = ResourceId::of("assets/images/ui/button_smallx_hover.png");
+const ResourceId ButtonNormal = ResourceId::of("assets/images/ui/button.png");
+const ResourceId ButtonHover = ResourceId::of("assets/images/ui/button_hover.png");
+const ResourceId ButtonDisabled = ResourceId::of("assets/images/ui/button_disabled.png");
+const ResourceId ClickSfx = ResourceId::of("assets/audio/effects/click.wav");
+const ResourceId HoverSfx = ResourceId::of("assets/audio/effects/hover.wav");
+//Textos de los botones (tambien se precalientan sus glifos)
+const char* const NewGameLabel = "Nuevo Juego";
+const char* const ContinueLabel = "Continuar";
+const char* const CreditsLabel = "Creditos";
+const unsigned ButtonTextSize = 36;
+const unsigned SmallButtonTextSize = 28;
+const ResourceId TitleMusic = ResourceId::of("assets/audio/title_music.ogg");
+}
+
+MainMenu::MainMenu(ResourceManager& res, AudioSystem& audioSystem, Vector2u windowSize)
 : resources(res),
-  bgFrame1(res.getTexture("assets/images/menu_bg_1.png")),
-  bgFrame2(res.getTexture("assets/images/menu_bg_2.png")),
-  titleFrame1(res.getTexture("assets/images/ui/title_01.png")),
-  titleFrame2(res.getTexture("assets/images/ui/title_02.png"))
+  bgFrame1(res.getTexture(MenuBg1)),
+  bgFrame2(res.getTexture(MenuBg2)),
+  titleFrame1(res.getRegion(Title1)),
+  titleFrame2(res.getRegion(Title2)),
+  audio(audioSystem)
 {
-    //Fondo
-    bgSprite.setTexture(bgFrame1);
-	//Filtro del fondo
-    filter.setTexture(
-        resources.getTexture("assets/images/vignette_filter.png")
-    );
+    //Fondo y filtro del fondo
+    fitBackgrounds();
     //Fuente
-    font = &resources.getFont("assets/fonts/title.ttf");
+    font = &resources.getFont(TitleFont);
     //Título
-    titleSprite.setTexture(titleFrame1);
+    applyRegion(titleSprite, titleFrame1);
     titleSprite.setPosition(120.f, 360.f);
     //Botones principales
-    setupButton(btnNew, "Nuevo Juego", { windowSize.x * 0.68f, windowSize.y * 0.35f });
-    setupButton(btnContinue, "Continuar", { windowSize.x * 0.68f, windowSize.y * 0.50f });
+    setupButton(btnNew, NewGameLabel, { windowSize.x * 0.68f, windowSize.y * 0.35f });
+    setupButton(btnContinue, ContinueLabel, { windowSize.x * 0.68f, windowSize.y * 0.50f });
     btnContinue.enabled = SaveManager::getInstance().exists();
     //Boton Creditos
-    btnCredits.normal   = &resources.getTexture("assets/images/ui/button_smallx.png");
-    btnCredits.hover    = &resources.getTexture("assets/images/ui/button_smallx_hover.png");
+    btnCredits.normal   = resources.getRegion(ButtonSmall);
+    btnCredits.hover    = resources.getRegion(ButtonSmallHover);
     btnCredits.disabled = btnCredits.normal;
-    btnCredits.sprite.setTexture(*btnCredits.normal);
+    applyRegion(btnCredits.sprite, btnCredits.normal);
 
     Vector2f creditsPos(
         windowSize.x - btnCredits.sprite.getGlobalBounds().width - 40.f,
@@ -37,9 +60,10 @@ MainMenu::MainMenu(ResourceManager& res, Vector2u windowSize)
 
     btnCredits.sprite.setPosition(creditsPos);
     btnCredits.text.setFont(*font);
-    btnCredits.text.setString("Creditos");
-    btnCredits.text.setCharacterSize(28);
+    btnCredits.text.setString(CreditsLabel);
+    btnCredits.text.setCharacterSize(SmallButtonTextSize);
     btnCredits.text.setFillColor(Color(61, 13, 30));
+    GlyphWarmup::getInstance().checkText(btnCredits.text);
 
     FloatRect t = btnCredits.text.getLocalBounds();
     btnCredits.text.setOrigin(t.width / 2, t.height / 2);
@@ -47,27 +71,45 @@ MainMenu::MainMenu(ResourceManager& res, Vector2u windowSize)
         creditsPos.x + btnCredits.sprite.getGlobalBounds().width / 2,
         creditsPos.y + btnCredits.sprite.getGlobalBounds().height / 2 - 2);
     //Audio UI
-    clickBuffer = resources.getSound("assets/audio/effects/click.wav");
-    clickSound.setBuffer(clickBuffer);
+    clickBuffer = resources.acquireSound(ClickSfx);
+    if (clickBuffer.get()){clickSound.setBuffer(*clickBuffer.get());}
     clickSound.setVolume(50.f);
-    hoverBuffer = resources.getSound("assets/audio/effects/hover.wav");
-    hoverSound.setBuffer(hoverBuffer);
+    hoverBuffer = resources.acquireSound(HoverSfx);
+    if (hoverBuffer.get()){hoverSound.setBuffer(*hoverBuffer.get());}
     hoverSound.setVolume(40.f);
 }
 
+void MainMenu::preloadAssets(ResourceManager& res) {
+    //Titulo y botones van al atlas: esos los decodifica quien arma el atlas
+    res.preloadImage(MenuBg1);
+    res.preloadImage(MenuBg2);
+    res.preloadImage(Vignette);
+    res.preloadSound(ClickSfx);
+    res.preloadSound(HoverSfx);
+}
+
+void MainMenu::warmGlyphs(ResourceManager& res) {
+    set<Uint32> chars;
+    for (const char* label : { NewGameLabel, ContinueLabel, CreditsLabel }) {
+        GlyphWarmup::collect(label, chars);
+    }
+    GlyphWarmup::getInstance().warm(res.getFont(TitleFont), chars, { ButtonTextSize, SmallButtonTextSize });
+}
+
 void MainMenu::setupButton(Button& btn, const string& label, Vector2f pos) {
 	//Estableces sprites de botones
-    btn.normal   = &resources.getTexture("assets/images/ui/button.png");
-    btn.hover    = &resources.getTexture("assets/images/ui/button_hover.png");
-    btn.disabled = &resources.getTexture("assets/images/ui/button_disabled.png");
+    btn.normal   = resources.getRegion(ButtonNormal);
+    btn.hover    = resources.getRegion(ButtonHover);
+    btn.disabled = resources.getRegion(ButtonDisabled);
 
-    btn.sprite.setTexture(*btn.normal);
+    applyRegion(btn.sprite, btn.normal);
     btn.sprite.setPosition(pos);
 
     btn.text.setFont(*font);
     btn.text.setString(label);
-    btn.text.setCharacterSize(36);
+    btn.text.setCharacterSize(ButtonTextSize);
     btn.text.setFillColor(Color(61, 13, 30));
+    GlyphWarmup::getInstance().checkText(btn.text);
 
     FloatRect bounds = btn.text.getLocalBounds();
     btn.text.setOrigin(bounds.width / 2, bounds.height / 2);
@@ -93,7 +135,18 @@ void MainMenu::handleEvent(const Event& ev, const RenderWindow& window) {
     checkClick(btnCredits, credits);
 }
 
+void MainMenu::fitBackgrounds() {
+    textureGeneration = resources.getTextureGeneration();
+    bgSprite.setTexture(bgToggle ? bgFrame2 : bgFrame1, true);
+    bgSprite.setScale(resources.getTextureScale(MenuBg1), resources.getTextureScale(MenuBg1));
+    filter.setTexture(resources.getTexture(Vignette), true);
+    filter.setScale(resources.getTextureScale(Vignette), resources.getTextureScale(Vignette));
+}
+
 void MainMenu::update(float dt, const RenderWindow& window) {
+    if (textureGeneration != resources.getTextureGeneration()) {
+        fitBackgrounds();
+    }
     bgTimer += dt;
     if (bgTimer >= bgFrameTime) {
         bgTimer = 0.f;
@@ -104,14 +157,14 @@ void MainMenu::update(float dt, const RenderWindow& window) {
 	if (titleTimer >= titleFrameTime) {
 	    titleTimer = 0.f;
 	    titleToggle = !titleToggle;
-	    titleSprite.setTexture(titleToggle ? titleFrame2 : titleFrame1);
+	    applyRegion(titleSprite, titleToggle ? titleFrame2 : titleFrame1);
 	}
     Vector2f mouse = (Vector2f)Mouse::getPosition(window);
     bool wasHovering = false;
 	auto updateHover = [&](Button& btn) {
 		if (!btn.normal || !btn.hover || !btn.disabled){return;}
 	    if (!btn.enabled) {
-	        btn.sprite.setTexture(*btn.disabled);
+	        applyRegion(btn.sprite, btn.disabled);
 	        btn.isHovered = false;
 	        return;
 	    }
@@ -121,7 +174,7 @@ void MainMenu::update(float dt, const RenderWindow& window) {
 	        hoverSound.stop();
 	        hoverSound.play();
 	    }
-	    btn.sprite.setTexture(hovering ? *btn.hover : *btn.normal);
+	    applyRegion(btn.sprite, hovering ? btn.hover : btn.normal);
 	    btn.isHovered = hovering;
 	};
     updateHover(btnNew);
@@ -148,19 +201,11 @@ bool MainMenu::continueRequested() const { return cont; }
 bool MainMenu::creditsRequested() const { return credits; }
 
 void MainMenu::playMusic() {
-    if (menuMusic.getStatus() == Music::Playing){return;}
-    if (!menuMusic.openFromFile("assets/audio/title_music.ogg")) {
-        cout << "ERROR: No se pudo cargar musica del menu\n";
-        return;
-    }
-    menuMusic.setLoop(true);
-    menuMusic.setVolume(45.f);
-    menuMusic.play();
+    audio.getMusic().play(TitleMusic, 45.f);
 }
 
 void MainMenu::stopMusic() {
-    if (menuMusic.getStatus() == sf::Music::Playing)
-        menuMusic.stop();
+    audio.getMusic().stop();
 }
 
 void MainMenu::playClickSound() {
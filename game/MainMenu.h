@@ -2,12 +2,17 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
 #include "src/core/ResourceManager.h"
+#include "src/audio/AudioSystem.h"
 using namespace sf;
 using namespace std;
 
 class MainMenu {
 public:
-    MainMenu(ResourceManager& resources, Vector2u windowSize);
+    MainMenu(ResourceManager& resources, AudioSystem& audio, Vector2u windowSize);
+    //Decodifica fondos y sfx del menu (desde otro hilo, antes de construirlo)
+    static void preloadAssets(ResourceManager& resources);
+    //Rasteriza los textos de los botones en su fuente (hilo principal, durante la carga)
+    static void warmGlyphs(ResourceManager& resources);
 
     void handleEvent(const Event& ev, const RenderWindow& window);
     void update(float dt, const RenderWindow& window);
@@ -24,9 +29,10 @@ private:
     struct Button {
         Sprite sprite;
         Text text;
-	    const Texture* normal;
-	    const Texture* hover;
-	    const Texture* disabled;
+	    //Regiones del atlas de UI: cambiar de estado no cambia de textura
+	    AtlasRegion normal;
+	    AtlasRegion hover;
+	    AtlasRegion disabled;
         bool enabled = true;
         bool isHovered = false;
     };
@@ -40,12 +46,15 @@ private:
     float bgTimer = 0.f;
     float bgFrameTime = 0.8f;
     bool bgToggle = false;
+    //Con un cambio de tier los fondos se recargan con otro tamaño: rect y escala de nuevo
+    unsigned textureGeneration = 0;
+    void fitBackgrounds();
     //Fuente
     Font* font = nullptr;
     //Titulo animado
     Sprite titleSprite;
-	const Texture& titleFrame1;
-	const Texture& titleFrame2;
+	AtlasRegion titleFrame1;
+	AtlasRegion titleFrame2;
     float titleTimer = 0.f;
     float titleFrameTime = 0.9f;
     bool titleToggle = false;
@@ -54,12 +63,13 @@ private:
     Button btnContinue;
     Button btnCredits;
     void setupButton(Button& btn, const string& label, Vector2f pos);
-	//Musica
-    Music menuMusic;
-	SoundBuffer clickBuffer;
+	//Musica (la toca el MusicPlayer compartido)
+    AudioSystem& audio;
+	//Handles al buffer del ResourceManager: sin copia y liberables junto con el menu
+	SoundHandle clickBuffer;
     Sound clickSound;
     void playClickSound();
-	SoundBuffer hoverBuffer;
+	SoundHandle hoverBuffer;
 	Sound hoverSound;
 	//Estados
     bool newGame = false;
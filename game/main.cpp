@@ -1,11 +1,22 @@
 // main.cpp - Remoria v0.6.9+
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <set>
+#include <filesystem>
+#include <future>
+#include <memory>
 #include <SFML/Graphics.hpp>
 #include <windows.h>
 #include "json.hpp"
 
 #include "src/core/ResourceManager.h"
+#include "src/core/AssetPack.h"
+#include "src/core/StartupTimeline.h"
+#include "src/graphics/GlyphWarmup.h"
+#include "src/graphics/LayoutCache.h"
+#include "src/visualnovel/SceneLoader.h"
+#include "src/audio/AudioSystem.h"
 #include "src/visualnovel/SceneManager.h"
 #include "src/save/SaveManager.h"
 #include "src/graphics/TransitionManager.h"
@@ -35,6 +46,68 @@ void toggleWindowedFullscreen(RenderWindow& window, bool& isMaximized, const str
     window.setView(view);
 }
 
+//Frames de personajes y widgets de UI: van al atlas al iniciar
+vector<ResourceId> atlasAssets() {
+    vector<ResourceId> ids;
+    //Sueltos y empaquetados (en una build solo existe el pack)
+    vector<string> characters = AssetPack::getInstance().list("assets/images/characters/");
+    error_code ec;
+    for (const auto& entry : filesystem::directory_iterator("assets/images/characters", ec)) {
+        characters.push_back(entry.path().generic_string());
+    }
+    for (const auto& path : characters) {
+        ResourceId id = ResourceId::of(path);
+        if (filesystem::path(path).extension() == ".png" && find(ids.begin(), ids.end(), id) == ids.end()) {
+            ids.push_back(id);
+        }
+    }
+    const char* ui[] = {
+        "assets/images/ui/button.png",
+        "assets/images/ui/button_hover.png",
+        "assets/images/ui/button_disabled.png",
+        "assets/images/ui/button_smallx.png",
+        "assets/images/ui/button_smallx_hover.png",
+        "assets/images/ui/title_01.png",
+        "assets/images/ui/title_02.png",
+        "assets/images/ui/dialogue_box.png"
+    };
+    for (const char* path : ui) {
+        ids.push_back(ResourceId::of(path));
+    }
+    return ids;
+}
+
+//Codepoints de dialogos, speakers y choices de todas las escenas (van al atlas de glifos)
+set<Uint32> storyCodepoints() {
+    vector<string> scenes = AssetPack::getInstance().list("data/scenes/");
+    error_code ec;
+    for (const auto& entry : filesystem::directory_iterator("data/scenes", ec)) {
+        scenes.push_back(entry.path().generic_string());
+    }
+    set<string> jsonPaths;
+    for (const auto& path : scenes) {
+        filesystem::path p(path);
+        //SceneLoader::load busca el .scnb a partir del .json
+        if (p.extension() == ".json" || p.extension() == ".scnb") {
+            jsonPaths.insert(p.replace_extension(".json").generic_string());
+        }
+    }
+    set<Uint32> chars;
+    for (const auto& path : jsonPaths) {
+        SceneData data;
+        if (!SceneLoader::load(path, data)){continue;}
+        for (const auto& step : data.steps) {
+            if (step.op != StepOp::Dialogue){continue;}
+            GlyphWarmup::collect(string(data.str(step.dialogue.speaker)), chars);
+            GlyphWarmup::collect(string(data.str(step.dialogue.text)), chars);
+        }
+        for (const auto& choice : data.choices) {
+            GlyphWarmup::collect(string(data.str(choice.text)), chars);
+        }
+    }
+    return chars;
+}
+
 enum class GameState {
     Intro,
     Menu,
@@ -42,13 +115,30 @@ enum class GameState {
     Playing
 };
 
+//Lo que se arma mientras corre la intro, en este orden
+enum class StartupStage {
+    Decode,
+    Atlas,
+    Glyphs,
+    Menu,
+    Credits,
+    Done
+};
+
 int main() {
+    StartupTimeline& timeline = StartupTimeline::getInstance();
     SetConsoleOutputCP(CP_UTF8);//Admite utf8 en consola
     cout<<"INICIANDO GAME ENIGNE..."<<endl;
+	//Pack de assets: si no esta se lee todo suelto
+    AssetPack::getInstance().open("Remoria.rpak");
 	//Carga de json de config
     json config;
+    const char* packedCfg = nullptr;
+    size_t packedCfgSize = 0;
     ifstream cfg("data/game_config.json");
-    if (!cfg.is_open()) {
+    if (AssetPack::getInstance().find(ResourceId::of("data/game_config.json"), packedCfg, packedCfgSize)) {
+        config = json::parse(packedCfg, packedCfg + packedCfgSize);
+    } else if (!cfg.is_open()) {
         config["window"]["width"] = 1920;
         config["window"]["height"] = 1080;
         config["window"]["title"] = "Remoria";
@@ -57,36 +147,110 @@ int main() {
         cfg >> config;
         cfg.close();
     }
+    timeline.mark("config");
     //Renderizar la ventana
     RenderWindow window(VideoMode(1920, 1080), config["window"].value("title", "Remoria~"), Style::Resize | Style::Close);
 	window.setFramerateLimit(60);
 	//Asignar icono del juego
 	Image icon;
-    if (!icon.loadFromFile("assets/images/icon.png")) {
+    if (!loadAsset(icon, ResourceId::of("assets/images/icon.png"))) {
         cout << "[System ERROR]: No se pudo cargar el icono del juego\n";
     } else {
         window.setIcon(icon.getSize().x, icon.getSize().y, icon.getPixelsPtr());
     }
+    timeline.mark("ventana");
 	//Inicia el Core
     ResourceManager resources;
-    SceneManager sceneManager(resources);
+    //Fondos con variantes por tier: ventana chica o memory_saver los carga a 1/2 o 1/4
+    bool memorySaver = config.value("visual", json::object()).value("memory_saver", false);
+    resources.setTieredPaths({ "assets/images/backgrounds/", "assets/images/menu_bg_", "assets/images/vignette_filter" });
+    resources.setTextureTier(ResourceManager::tierFor(window.getSize(), memorySaver));
+    //Pngs ya decodificados: la segunda vez que se abre el juego no se infla ningun png
+    resources.setRawCacheDirectory("cache/textures");
+    //Cortes de linea de los dialogos ya vistos (en partidas anteriores): no se vuelven a calcular
+    const string layoutCachePath = "cache/layout.bin";
+    LayoutCache::getInstance().load(layoutCachePath);
+    AudioSystem audio(resources);
+    audio.getVoiceBank().loadConfig(config["voices"]);
+    audio.getMusic().setBufferMs(config.value("audio", json::object()).value("music_buffer_ms", 500u));
+    SceneManager sceneManager(resources, audio);
     sceneManager.setScreenSize(window.getSize());
-	//Inicia Mainmenu
-    MainMenu menu(resources, window.getSize());
-    CreditsScreen creditsScreen(resources, window.getSize());
-	//Inicia Intro
+	//Inicia Intro: es lo unico que necesita el primer frame
     IntroScreen intro(resources, window.getSize());
     intro.addLogo("assets/images/intro/company_logo.png", 3.0f, Color::Black);
     intro.addLogo("assets/images/intro/made_with.png", 2.5f, Color(34, 3, 12));
 	//Inicia las transiciones
     TransitionManager transition;
     transition.setScreenSize(window.getSize());
+    timeline.mark("core");
+    //Menu y creditos se arman mientras corre la intro: las imagenes se decodifican en otro hilo
+    //y la subida a GPU + construccion se hace aca, una etapa por frame
+    unique_ptr<MainMenu> menu;
+    unique_ptr<CreditsScreen> creditsScreen;
+    StartupStage startup = StartupStage::Decode;
+    vector<ResourceId> atlasIds = atlasAssets();
+    set<Uint32> storyChars;
+    future<void> decoding = async(launch::async, [&resources, atlasIds, &storyChars]() {
+        for (ResourceId id : atlasIds) {
+            resources.preloadImage(id);
+        }
+        MainMenu::preloadAssets(resources);
+        storyChars = storyCodepoints();
+    });
+    //wait: la intro termino y el menu hace falta ya
+    auto advanceStartup = [&](bool wait) {
+        switch (startup) {
+            case StartupStage::Decode:
+                if (!wait && decoding.wait_for(chrono::seconds(0)) != future_status::ready){return;}
+                decoding.get();
+                timeline.mark("decodificacion");
+                startup = StartupStage::Atlas;
+                break;
+            case StartupStage::Atlas:
+                resources.buildAtlas(atlasIds);
+                timeline.mark("atlas");
+                startup = StartupStage::Glyphs;
+                break;
+            case StartupStage::Glyphs: {
+                //Todo lo que se escribe con default.ttf a los tamaños de la caja de dialogo y los creditos
+                //Desde la segunda vez el atlas se lee de la cache (se rehace si la historia trae glifos nuevos)
+                set<Uint32> atlasChars = storyChars;
+                CreditsScreen::collectAtlasText(atlasChars);
+                ResourceId dialogueFont = ResourceId::of("assets/fonts/default.ttf");
+                vector<unsigned> dialogueSizes = { 18, 26, 32 };
+                if (!resources.buildGlyphAtlas(dialogueFont, dialogueSizes, vector<Uint32>(atlasChars.begin(), atlasChars.end()), "cache/fonts/default.glyphs")) {
+                    //Sin atlas se dibuja con la Font: que al menos ya tenga los glifos
+                    GlyphWarmup::getInstance().warm(resources.getFont(dialogueFont), atlasChars, dialogueSizes);
+                }
+                MainMenu::warmGlyphs(resources);
+                CreditsScreen::warmGlyphs(resources);
+                cout << "[Glyphs] Precalentados " << GlyphWarmup::getInstance().warmedGlyphs() << " glifos ("
+                     << storyChars.size() << " codepoints en la historia)" << endl;
+                timeline.mark("glifos");
+                startup = StartupStage::Menu;
+                break;
+            }
+            case StartupStage::Menu:
+                menu = make_unique<MainMenu>(resources, audio, window.getSize());
+                timeline.mark("menu");
+                startup = StartupStage::Credits;
+                break;
+            case StartupStage::Credits:
+                creditsScreen = make_unique<CreditsScreen>(resources, window.getSize());
+                timeline.mark("creditos");
+                startup = StartupStage::Done;
+                break;
+            case StartupStage::Done:
+                break;
+        }
+    };
     //GameState, estado actual del juego :3
     GameState state = GameState::Intro;
 
     bool showingCredits = false;
     string sceneToLoad;
     int stepToLoad = 0;
+    bool firstFrameShown = false;
     Clock clock;
     cout<<"GAME ENIGNE INICIADO!!!"<<endl;
 	//Sfml abre la ventana en loop
@@ -96,9 +260,13 @@ int main() {
         	if (ev.type == Event::Closed){
         		window.close();
 			}
+        	if (ev.type == Event::Resized){
+        		resources.setTextureTier(ResourceManager::tierFor(window.getSize(), memorySaver));
+			}
         	if (ev.type == Event::KeyPressed) {
 			    if (ev.key.code == Keyboard::F) {
 			        toggleWindowedFullscreen(window,isMaximized,config["window"].value("title", "Remoria~"),icon);
+			        resources.setTextureTier(ResourceManager::tierFor(window.getSize(), memorySaver));
 			        sceneManager.setScreenSize(window.getSize());
 			        transition.setScreenSize(window.getSize());
 			    }
@@ -107,43 +275,56 @@ int main() {
                 intro.handleEvent(ev);
             } else if (state == GameState::Menu) {
                 if (showingCredits){
-                	creditsScreen.handleEvent(ev);
+                	creditsScreen->handleEvent(ev);
 				} else {
-					menu.handleEvent(ev, window);
+					menu->handleEvent(ev, window);
 				}
             } else if (state == GameState::Playing) {
                 sceneManager.handleEvent(ev);
             }
         }
         float dt = clock.restart().asSeconds();
+        //Sube a la GPU lo que el pool de carga ya decodifico
+        resources.update();
+        //Libera voces terminadas y dispara los sfx que ya decodificaron
+        audio.update(dt);
+        if (startup != StartupStage::Done) {
+            advanceStartup(false);
+        }
 		//Estado de Updates
         if (state == GameState::Intro) {
             intro.update(dt);
             if (intro.isFinished()) {
-                menu.playMusic();
+                //Si la intro se salteo, lo que falte se arma ahora
+                while (startup != StartupStage::Done) {
+                    advanceStartup(true);
+                }
+                menu->playMusic();
                 state = GameState::Menu;
+                timeline.mark("menu interactivo");
+                timeline.report();
             }
         } else if (state == GameState::Menu) {
-            menu.update(dt, window);
+            menu->update(dt, window);
 			//Muestra creditos como capa de arriba
-            if (!showingCredits && menu.creditsRequested()) {
+            if (!showingCredits && menu->creditsRequested()) {
                 cout << "[Main] Mostrando créditos" << endl;
-                creditsScreen.reset();
-                menu.resetCreditsRequest();
+                creditsScreen->reset();
+                menu->resetCreditsRequest();
                 showingCredits = true;
             } else if (showingCredits) {
-                creditsScreen.update(dt);
-                if (creditsScreen.backRequested()) {
+                creditsScreen->update(dt);
+                if (creditsScreen->backRequested()) {
                     cout << "[Main] Cerrando créditos" << endl;
-                    creditsScreen.reset();
+                    creditsScreen->reset();
                     showingCredits = false;
                 }
-            } else if (menu.startNewGameRequested()) { //Inicia juego...
+            } else if (menu->startNewGameRequested()) { //Inicia juego...
                 transition.start(TransitionManager::Type::FADE_TO_BLACK, 1.f);
                 sceneToLoad = "data/scenes/prologue.json";
                 stepToLoad = 0;
                 state = GameState::TransitionToGame;
-            } else if (menu.continueRequested()) {
+            } else if (menu->continueRequested()) {
                 string sceneId;
                 if (SaveManager::getInstance().load(sceneId, stepToLoad)) {
                     transition.start(TransitionManager::Type::FADE_TO_BLACK, 1.f);
@@ -154,7 +335,7 @@ int main() {
         } else if (state == GameState::TransitionToGame) {
             transition.update(dt);
             if (transition.isComplete()) {
-                menu.stopMusic();
+                menu->stopMusic();
                 sceneManager.loadScene(sceneToLoad, stepToLoad);
                 transition.reset();
                 state = GameState::Playing;
@@ -167,17 +348,25 @@ int main() {
         if (state == GameState::Intro) {
             intro.draw(window);
         } else if (state == GameState::Menu) {
-            menu.draw(window);
+            menu->draw(window);
             if (showingCredits)
-                creditsScreen.draw(window);
+                creditsScreen->draw(window);
         } else if (state == GameState::TransitionToGame) {
-            menu.draw(window);
+            menu->draw(window);
             transition.draw(window);
         } else if (state == GameState::Playing) {
             sceneManager.draw(window);
         }
         window.display();
+        if (!firstFrameShown) {
+            timeline.mark("primer frame");
+            firstFrameShown = true;
+        }
     }
+    LayoutCache::getInstance().save(layoutCachePath);
+    LayoutCache::getInstance().report();
+    //Glifos que igual hubo que rasterizar en medio del juego
+    GlyphWarmup::getInstance().report();
     return 0;
 }
 //end main.cpp - Remoria v0.6.9+
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "AudioSystem.h"
+#include "../core/AssetPack.h"
+
+AudioSystem::AudioSystem(ResourceManager& res)
+: resources(res),
+  voices(res),
+  streamVoices(4),
+  streamCounter(0)
+{
+    //Reservado una vez: encolar un sfx no reserva memoria
+    pendingSounds.reserve(sounds.voiceCount());
+    for (auto& voice : streamVoices) {
+        voice.music = make_unique<Music>();
+    }
+}
+
+void AudioSystem::playSound(ResourceId id, float volume, int priority) {
+    if (!id){return;}
+    if (SoundPolicy::getInstance().shouldStream(id)) {
+        playStreamed(id, volume);
+        return;
+    }
+    SoundHandle handle = resources.loadSoundAsync(id);
+    if (handle.ready()) {
+        sounds.play(handle, volume, priority);
+    } else if (!handle.failed() && pendingSounds.size() < pendingSounds.capacity()) {
+        pendingSounds.push_back(PendingSound{ move(handle), volume, priority });
+    }
+}
+
+void AudioSystem::update(float dt) {
+    sounds.update();
+    music.update(dt);
+    for (size_t i = 0; i < pendingSounds.size();) {
+        PendingSound& p = pendingSounds[i];
+        if (p.sound.ready()) {
+            sounds.play(p.sound, p.volume, p.priority);
+        } else if (!p.sound.failed()) {
+            ++i;
+            continue;
+        }
+        //Sin erase: el ultimo ocupa su lugar
+        p = move(pendingSounds.back());
+        pendingSounds.pop_back();
+    }
+}
+
+void AudioSystem::playStreamed(ResourceId id, float volume) {
+    //La misma pista ya sonando se reinicia; si no, una libre o la mas vieja
+    StreamVoice* voice = nullptr;
+    for (auto& v : streamVoices) {
+        if (v.id == id){voice = &v; break;}
+    }
+    if (!voice) {
+        for (auto& v : streamVoices) {
+            if (v.music->getStatus() != SoundSource::Playing){voice = &v; break;}
+            if (!voice || v.startedAt < voice->startedAt){voice = &v;}
+        }
+    }
+    voice->music->stop();
+    if (voice->id != id) {
+        voice->id = ResourceId();
+        if (!openAsset(*voice->music, id)) {
+            cerr << "ERROR: No se pudo abrir sonido en stream: " << id.path() << endl;
+            return;
+        }
+        voice->id = id;
+    }
+    voice->music->setVolume(volume);
+    voice->music->play();
+    voice->startedAt = ++streamCounter;
+}
+
+void AudioSystem::stopSounds() {
+    sounds.stopAll();
+    pendingSounds.clear();
+    for (auto& voice : streamVoices) {
+        voice.music->stop();
+    }
+}
+
+SoundPool& AudioSystem::getSoundPool() {
+    return sounds;
+}
+
+VoiceBank& AudioSystem::getVoiceBank() {
+    return voices;
+}
+
+MusicPlayer& AudioSystem::getMusic() {
+    return music;
+}
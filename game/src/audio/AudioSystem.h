@@ -0,0 +1,51 @@
+#ifndef AUDIO_SYSTEM_H
+#define AUDIO_SYSTEM_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "../core/ResourceManager.h"
+#include "SoundPool.h"
+#include "VoiceBank.h"
+#include "MusicPlayer.h"
+#include "SoundPolicy.h"
+using namespace std;
+
+//Audio compartido por todas las escenas (vive mientras corre el juego)
+class AudioSystem {
+public:
+    explicit AudioSystem(ResourceManager& res);
+    AudioSystem(const AudioSystem&) = delete;
+    AudioSystem& operator=(const AudioSystem&) = delete;
+    //Sfx de un disparo; si el buffer todavia se decodifica suena apenas este listo
+    //Los largos (ambiente) no se decodifican enteros: van a una voz de stream (ver SoundPolicy)
+    void playSound(ResourceId id, float volume = 100.f, int priority = 0);
+    //Una vez por frame, despues de ResourceManager::update()
+    void update(float dt);
+    void stopSounds();
+    SoundPool& getSoundPool();
+    VoiceBank& getVoiceBank();
+    MusicPlayer& getMusic();
+private:
+    ResourceManager& resources;
+    SoundPool sounds;
+    VoiceBank voices;
+    MusicPlayer music;
+    struct PendingSound {
+        SoundHandle sound;
+        float volume;
+        int priority;
+    };
+    vector<PendingSound> pendingSounds;
+    //Voces de stream: leen del pack o del disco de a poco, sin PCM residente
+    struct StreamVoice {
+        unique_ptr<Music> music;
+        ResourceId id;
+        uint64_t startedAt = 0;
+    };
+    vector<StreamVoice> streamVoices;
+    uint64_t streamCounter;
+    void playStreamed(ResourceId id, float volume);
+};
+
+#endif
@@ -0,0 +1,312 @@
+#include "MusicPlayer.h"
+#include "../core/AssetPack.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+namespace {
+//Cada entrega al stream de SFML: ~50ms
+const unsigned ChunkMs = 50;
+//Cada cuanto el hilo rellena aunque nadie lo despierte
+const unsigned RefillMs = 10;
+}
+
+MusicPlayer::Slot::Slot()
+: channelCount(0),
+  sampleRate(0),
+  state(SlotState::Idle),
+  readyRequest(0),
+  readPos(0),
+  writePos(0),
+  underruns(0),
+  role(Role::Free),
+  request(0),
+  volume(0.f),
+  target(0.f),
+  fadeSpeed(0.f)
+{
+}
+
+MusicPlayer::Slot::~Slot() {
+    //El hilo de SFML lee el ring: pararlo antes de destruirlo
+    SoundStream::stop();
+}
+
+bool MusicPlayer::Slot::open(ResourceId id, unsigned ms) {
+    //Del pack lee directo del mapeo, sin copiar el archivo
+    if (!openAsset(file, id)) {
+        return false;
+    }
+    channelCount = file.getChannelCount();
+    sampleRate = file.getSampleRate();
+    if (channelCount == 0 || sampleRate == 0){return false;}
+    size_t chunkSamples = size_t(sampleRate) * ChunkMs / 1000 * channelCount;
+    //Al menos 4 entregas en el ring para que el hilo tenga margen
+    size_t ringSamples = max(size_t(sampleRate) * ms / 1000 * channelCount, chunkSamples * 4);
+    ring.assign(ringSamples - ringSamples % channelCount, 0);
+    chunk.assign(chunkSamples, 0);
+    readPos = 0;
+    writePos = 0;
+    fill();
+    return true;
+}
+
+void MusicPlayer::Slot::fill() {
+    //Lee directo al ring, de a tramos contiguos; al final del archivo vuelve al inicio (loop)
+    bool rewound = false;
+    while (true) {
+        size_t used = writePos.load(memory_order_relaxed) - readPos.load(memory_order_acquire);
+        size_t free = ring.size() - used;
+        size_t at = writePos.load(memory_order_relaxed) % ring.size();
+        size_t want = min(free, ring.size() - at);
+        want -= want % channelCount;
+        if (want == 0){return;}
+        Uint64 got = file.read(&ring[at], want);
+        if (got == 0) {
+            //Archivo vacio o roto: no girar para siempre
+            if (rewound){return;}
+            file.seek(Uint64(0));
+            rewound = true;
+            continue;
+        }
+        rewound = false;
+        writePos.store(writePos.load(memory_order_relaxed) + size_t(got), memory_order_release);
+    }
+}
+
+void MusicPlayer::Slot::start() {
+    //Hilo principal, con el stream detenido
+    initialize(channelCount, sampleRate);
+    SoundStream::setVolume(volume);
+    play();
+}
+
+bool MusicPlayer::Slot::onGetData(Chunk& data) {
+    size_t available = writePos.load(memory_order_acquire) - readPos.load(memory_order_relaxed);
+    size_t n = min(available, chunk.size());
+    n -= n % channelCount;
+    if (n == 0) {
+        //Se quedo sin audio: silencio en vez de cortar el stream
+        underruns.fetch_add(1, memory_order_relaxed);
+        fill_n(chunk.begin(), chunk.size(), Int16(0));
+        data.samples = chunk.data();
+        data.sampleCount = chunk.size();
+        return true;
+    }
+    size_t at = readPos.load(memory_order_relaxed) % ring.size();
+    size_t first = min(n, ring.size() - at);
+    memcpy(chunk.data(), &ring[at], first * sizeof(Int16));
+    memcpy(chunk.data() + first, ring.data(), (n - first) * sizeof(Int16));
+    readPos.store(readPos.load(memory_order_relaxed) + n, memory_order_release);
+    data.samples = chunk.data();
+    data.sampleCount = n;
+    return true;
+}
+
+void MusicPlayer::Slot::onSeek(Time) {
+    //La posicion la maneja el hilo de decode (stop() llama aca con 0)
+}
+
+MusicPlayer::MusicPlayer()
+: stopping(false),
+  bufferMs(500),
+  reportedUnderruns(0)
+{
+    worker = thread(&MusicPlayer::run, this);
+}
+
+MusicPlayer::~MusicPlayer() {
+    for (auto& slot : slots) {
+        slot.SoundStream::stop();
+    }
+    {
+        lock_guard<mutex> lock(commandMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    worker.join();
+}
+
+void MusicPlayer::setBufferMs(unsigned ms) {
+    bufferMs = max(ms, 100u);
+}
+
+void MusicPlayer::run() {
+    while (true) {
+        deque<Command> todo;
+        {
+            unique_lock<mutex> lock(commandMutex);
+            wakeUp.wait_for(lock, chrono::milliseconds(RefillMs), [this] { return stopping || !commands.empty(); });
+            if (stopping){return;}
+            todo.swap(commands);
+        }
+        for (const Command& cmd : todo) {
+            Slot& slot = slots[cmd.slot];
+            if (!cmd.open) {
+                slot.state = SlotState::Idle;
+                continue;
+            }
+            slot.state = SlotState::Opening;
+            bool ok = slot.open(cmd.track, bufferMs);
+            if (!ok) {
+                cerr << "[System ERROR] No se pudo cargar música: " << cmd.track.path() << endl;
+            }
+            slot.state = ok ? SlotState::Ready : SlotState::Failed;
+            slot.readyRequest = cmd.request;
+        }
+        for (auto& slot : slots) {
+            if (slot.state == SlotState::Ready) {
+                slot.fill();
+            }
+        }
+    }
+}
+
+void MusicPlayer::requestOpen(Slot& slot, ResourceId track) {
+    slot.role = Role::Incoming;
+    slot.track = track;
+    slot.request++;
+    {
+        lock_guard<mutex> lock(commandMutex);
+        commands.push_back(Command{ int(&slot - slots), track, slot.request, true });
+    }
+    wakeUp.notify_all();
+}
+
+void MusicPlayer::release(Slot& slot) {
+    slot.SoundStream::stop();
+    slot.role = Role::Free;
+    slot.track = ResourceId();
+    slot.volume = 0.f;
+    //Si habia una apertura en camino queda descartada por el numero de pedido
+    slot.request++;
+    {
+        lock_guard<mutex> lock(commandMutex);
+        commands.push_back(Command{ int(&slot - slots), ResourceId(), slot.request, false });
+    }
+    wakeUp.notify_all();
+}
+
+int MusicPlayer::find(Role role) const {
+    for (int i = 0; i < 2; ++i) {
+        if (slots[i].role == role){return i;}
+    }
+    return -1;
+}
+
+void MusicPlayer::fadeTo(Slot& slot, float target, float seconds) {
+    slot.target = target;
+    //Velocidad en volumen por segundo; 0 = salto inmediato
+    slot.fadeSpeed = seconds > 0.f ? max(fabs(target - slot.volume), 1.f) / seconds : 0.f;
+}
+
+void MusicPlayer::play(ResourceId track, float volume, float fadeSeconds) {
+    if (!track){return;}
+    int current = find(Role::Current);
+    int incoming = find(Role::Incoming);
+    if (current >= 0 && slots[current].track == track && slots[current].target > 0.f) {
+        //Ya suena: solo volumen, y se cancela lo que estuviera por entrar
+        fadeTo(slots[current], volume, fadeSeconds);
+        if (incoming >= 0){release(slots[incoming]);}
+        return;
+    }
+    int fading = find(Role::FadingOut);
+    if (current < 0 && fading >= 0 && slots[fading].track == track) {
+        //Se estaba yendo (stop y play seguidos): vuelve sin reabrir
+        if (incoming >= 0){release(slots[incoming]);}
+        slots[fading].role = Role::Current;
+        fadeTo(slots[fading], volume, fadeSeconds);
+        return;
+    }
+    if (incoming >= 0) {
+        Slot& slot = slots[incoming];
+        if (slot.track != track){requestOpen(slot, track);}
+        slot.target = volume;
+        slot.fadeSpeed = fadeSeconds;
+        return;
+    }
+    int free = find(Role::Free);
+    if (free < 0) {
+        //Una sonando y otra saliendo: la que sale se corta ya
+        free = find(Role::FadingOut);
+        release(slots[free]);
+    }
+    Slot& slot = slots[free];
+    requestOpen(slot, track);
+    //Hasta que entre, fadeSpeed guarda los segundos de crossfade
+    slot.target = volume;
+    slot.fadeSpeed = fadeSeconds;
+}
+
+void MusicPlayer::setVolume(float volume, float fadeSeconds) {
+    int current = find(Role::Current);
+    if (current >= 0){fadeTo(slots[current], volume, fadeSeconds);}
+    int incoming = find(Role::Incoming);
+    if (incoming >= 0){slots[incoming].target = volume;}
+}
+
+void MusicPlayer::stop(float fadeSeconds) {
+    int incoming = find(Role::Incoming);
+    if (incoming >= 0){release(slots[incoming]);}
+    int current = find(Role::Current);
+    if (current >= 0) {
+        Slot& slot = slots[current];
+        slot.role = Role::FadingOut;
+        fadeTo(slot, 0.f, fadeSeconds);
+    }
+}
+
+void MusicPlayer::update(float dt) {
+    int incoming = find(Role::Incoming);
+    if (incoming >= 0) {
+        Slot& slot = slots[incoming];
+        if (slot.readyRequest == slot.request && slot.state == SlotState::Failed) {
+            release(slot);
+        } else if (slot.readyRequest == slot.request && slot.state == SlotState::Ready) {
+            float fade = slot.fadeSpeed;
+            float volume = slot.target;
+            int current = find(Role::Current);
+            if (current >= 0) {
+                slots[current].role = Role::FadingOut;
+                fadeTo(slots[current], 0.f, fade);
+            }
+            slot.volume = fade > 0.f ? 0.f : volume;
+            fadeTo(slot, volume, fade);
+            slot.role = Role::Current;
+            slot.start();
+            cout << "[Music] ♪ Reproduciendo~: " << slot.track.path() << endl;
+        }
+    }
+    for (auto& slot : slots) {
+        if (slot.role != Role::Current && slot.role != Role::FadingOut){continue;}
+        if (slot.volume != slot.target) {
+            float step = slot.fadeSpeed > 0.f ? slot.fadeSpeed * dt : fabs(slot.target - slot.volume);
+            if (fabs(slot.target - slot.volume) <= step) {
+                slot.volume = slot.target;
+            } else {
+                slot.volume += slot.volume < slot.target ? step : -step;
+            }
+            slot.SoundStream::setVolume(slot.volume);
+        }
+        if (slot.role == Role::FadingOut && slot.volume <= 0.f) {
+            release(slot);
+        }
+    }
+    size_t total = underruns();
+    if (total != reportedUnderruns) {
+        cerr << "[Music] WARNING: el stream se quedo sin audio (" << total << " underruns)" << endl;
+        reportedUnderruns = total;
+    }
+}
+
+ResourceId MusicPlayer::current() const {
+    int incoming = find(Role::Incoming);
+    if (incoming >= 0){return slots[incoming].track;}
+    int current = find(Role::Current);
+    return current >= 0 ? slots[current].track : ResourceId();
+}
+
+size_t MusicPlayer::underruns() const {
+    return slots[0].underruns + slots[1].underruns;
+}
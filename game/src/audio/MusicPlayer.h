@@ -0,0 +1,103 @@
+#ifndef MUSIC_PLAYER_H
+#define MUSIC_PLAYER_H
+
+#include <SFML/Audio.hpp>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include "../core/ResourceId.h"
+using namespace std;
+using namespace sf;
+
+//Una sola musica para todo el juego: dos slots de streaming y un hilo que decodifica
+//El hilo abre la pista siguiente mientras suena la actual; cuando tiene el buffer lleno
+//entra con crossfade (o corte si fade es 0). El hilo principal nunca abre ni lee un .ogg
+class MusicPlayer {
+public:
+    MusicPlayer();
+    ~MusicPlayer();
+    MusicPlayer(const MusicPlayer&) = delete;
+    MusicPlayer& operator=(const MusicPlayer&) = delete;
+    //Audio decodificado por adelantado en cada slot (vale para las pistas que se abran despues)
+    void setBufferMs(unsigned ms);
+    //Si ya suena esta pista solo ajusta el volumen
+    void play(ResourceId track, float volume = 70.f, float fadeSeconds = 1.f);
+    void setVolume(float volume, float fadeSeconds = 0.f);
+    void stop(float fadeSeconds = 1.f);
+    //Hilo principal, una vez por frame: arranca lo que ya tiene buffer y avanza los fades
+    void update(float dt);
+    //Pista que suena o que esta por entrar
+    ResourceId current() const;
+    //Veces que un slot se quedo sin audio decodificado (deberia ser 0)
+    size_t underruns() const;
+private:
+    enum class SlotState : uint8_t {
+        Idle,
+        Opening,
+        Ready,
+        Failed
+    };
+    enum class Role : uint8_t {
+        Free,
+        Incoming,
+        Current,
+        FadingOut
+    };
+    //Stream que lee de un ring buffer: lo llena el hilo de decode, lo vacia el hilo de SFML
+    class Slot : public SoundStream {
+    public:
+        Slot();
+        ~Slot();
+        //Solo hilo de decode
+        InputSoundFile file;
+        vector<Int16> ring;
+        unsigned channelCount;
+        unsigned sampleRate;
+        bool open(ResourceId track, unsigned bufferMs);
+        void fill();
+        void start();
+        //Compartido
+        atomic<SlotState> state;
+        atomic<uint32_t> readyRequest;
+        atomic<size_t> readPos;
+        atomic<size_t> writePos;
+        atomic<size_t> underruns;
+        //Solo hilo principal
+        Role role;
+        ResourceId track;
+        uint32_t request;
+        float volume;
+        float target;
+        float fadeSpeed;
+    private:
+        vector<Int16> chunk;
+        bool onGetData(Chunk& data) override;
+        void onSeek(Time timeOffset) override;
+    };
+    struct Command {
+        int slot;
+        ResourceId track;
+        uint32_t request;
+        bool open;
+    };
+    Slot slots[2];
+    thread worker;
+    mutex commandMutex;
+    condition_variable wakeUp;
+    deque<Command> commands;
+    bool stopping;
+    atomic<unsigned> bufferMs;
+    size_t reportedUnderruns;
+    void run();
+    void requestOpen(Slot& slot, ResourceId track);
+    //Corta ya: detiene el stream y devuelve el slot al hilo de decode
+    void release(Slot& slot);
+    int find(Role role) const;
+    static void fadeTo(Slot& slot, float target, float seconds);
+};
+
+#endif
@@ -0,0 +1,45 @@
+#include "SoundPolicy.h"
+#include "../core/AssetPack.h"
+#include <iostream>
+
+SoundPolicy::SoundPolicy()
+: streamSeconds(4.5f),
+  streamBytes(1u << 20)
+{
+}
+
+SoundPolicy& SoundPolicy::getInstance() {
+    static SoundPolicy instance;
+    return instance;
+}
+
+void SoundPolicy::setStreamThreshold(float seconds, size_t pcmBytes) {
+    lock_guard<mutex> lock(policyMutex);
+    streamSeconds = seconds;
+    streamBytes = pcmBytes;
+    decisions.clear();
+}
+
+bool SoundPolicy::shouldStream(ResourceId id) {
+    {
+        lock_guard<mutex> lock(policyMutex);
+        auto it = decisions.find(id);
+        if (it != decisions.end()){return it->second;}
+    }
+    //Abrir solo parsea la cabecera: no decodifica muestras
+    InputSoundFile probe;
+    bool stream = false;
+    if (openAsset(probe, id) && probe.getSampleRate() > 0 && probe.getChannelCount() > 0) {
+        Uint64 samples = probe.getSampleCount();
+        float seconds = float(samples) / (probe.getSampleRate() * probe.getChannelCount());
+        size_t pcm = size_t(samples) * sizeof(Int16);
+        stream = seconds > streamSeconds || pcm > streamBytes;
+        if (stream) {
+            cout << "[Audio] En stream: " << id.path() << " (" << seconds << " s, " << pcm / 1024 << " KB de PCM)" << endl;
+        }
+    }
+    //Si no se pudo abrir va por el buffer, que reporta el error al cargarlo
+    lock_guard<mutex> lock(policyMutex);
+    decisions[id] = stream;
+    return stream;
+}
@@ -0,0 +1,28 @@
+#ifndef SOUND_POLICY_H
+#define SOUND_POLICY_H
+
+#include <SFML/Audio.hpp>
+#include <unordered_map>
+#include <mutex>
+#include "../core/ResourceId.h"
+using namespace std;
+using namespace sf;
+
+//Decide por archivo si un sfx se decodifica entero (buffer compartido) o se reproduce en stream
+//Solo lee la cabecera la primera vez; la decision queda guardada
+class SoundPolicy {
+public:
+    static SoundPolicy& getInstance();
+    //Seguro desde cualquier hilo (el prefetcher pregunta antes de precargar)
+    bool shouldStream(ResourceId id);
+    //Mas largo que esto, o mas PCM que esto, va en stream
+    void setStreamThreshold(float seconds, size_t pcmBytes);
+private:
+    SoundPolicy();
+    mutex policyMutex;
+    unordered_map<ResourceId, bool, ResourceIdHash> decisions;
+    float streamSeconds;
+    size_t streamBytes;
+};
+
+#endif
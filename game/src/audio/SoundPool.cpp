@@ -0,0 +1,96 @@
+#include "SoundPool.h"
+
+SoundPool::SoundPool(size_t voiceCount, size_t maxPerSound)
+: voices(voiceCount),
+  defaultLimit(maxPerSound),
+  playCounter(0)
+{
+}
+
+bool SoundPool::play(const SoundHandle& buffer, float volume, int priority) {
+    if (!buffer.ready()){return false;}
+    Voice* voice = pickVoice(buffer.id(), priority);
+    if (!voice){return false;}
+    if (voice->buffer.id() != buffer.id()) {
+        voice->sound.stop();
+        voice->sound.setBuffer(*buffer.get());
+        voice->buffer = buffer;
+    }
+    voice->sound.setVolume(volume);
+    //play() sobre una voz que sonaba la reinicia desde el principio
+    voice->sound.stop();
+    voice->sound.play();
+    voice->priority = priority;
+    voice->startedAt = ++playCounter;
+    voice->active = true;
+    return true;
+}
+
+SoundPool::Voice* SoundPool::pickVoice(ResourceId id, int priority) {
+    //Rafagas del mismo sfx: al llegar al tope se reinicia su voz mas vieja
+    size_t sameCount = 0;
+    Voice* oldestSame = nullptr;
+    for (auto& v : voices) {
+        if (!v.active || v.buffer.id() != id){continue;}
+        sameCount++;
+        if (!oldestSame || v.startedAt < oldestSame->startedAt){oldestSame = &v;}
+    }
+    if (oldestSame && sameCount >= limitFor(id)){return oldestSame;}
+    //Libre: mejor una que ya tenga este buffer, si no la que hace mas que no se usa
+    Voice* idle = nullptr;
+    for (auto& v : voices) {
+        if (v.active){continue;}
+        if (v.buffer.id() == id){return &v;}
+        if (!idle || v.startedAt < idle->startedAt){idle = &v;}
+    }
+    if (idle){return idle;}
+    //Todas sonando: se roba la de menor prioridad (y entre iguales la mas vieja)
+    Voice* victim = nullptr;
+    for (auto& v : voices) {
+        if (!victim || v.priority < victim->priority
+            || (v.priority == victim->priority && v.startedAt < victim->startedAt)) {
+            victim = &v;
+        }
+    }
+    return victim && victim->priority <= priority ? victim : nullptr;
+}
+
+size_t SoundPool::limitFor(ResourceId id) const {
+    auto it = limits.find(id);
+    return it != limits.end() ? it->second : defaultLimit;
+}
+
+void SoundPool::setSoundLimit(ResourceId id, size_t maxVoices) {
+    limits[id] = maxVoices > 0 ? maxVoices : 1;
+}
+
+void SoundPool::setDefaultLimit(size_t maxVoices) {
+    defaultLimit = maxVoices > 0 ? maxVoices : 1;
+}
+
+void SoundPool::update() {
+    for (auto& v : voices) {
+        if (v.active && v.sound.getStatus() == Sound::Stopped) {
+            v.active = false;
+        }
+    }
+}
+
+void SoundPool::stopAll() {
+    for (auto& v : voices) {
+        v.sound.stop();
+        v.active = false;
+    }
+}
+
+size_t SoundPool::activeVoices() const {
+    size_t n = 0;
+    for (const auto& v : voices) {
+        if (v.active){n++;}
+    }
+    return n;
+}
+
+size_t SoundPool::voiceCount() const {
+    return voices.size();
+}
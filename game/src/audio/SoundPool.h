@@ -0,0 +1,44 @@
+#ifndef SOUND_POOL_H
+#define SOUND_POOL_H
+
+#include <SFML/Audio.hpp>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "../core/ResourceManager.h"
+using namespace std;
+using namespace sf;
+
+//Voces fijas que se reutilizan: disparar un sfx no reserva memoria
+//y nunca hay mas fuentes de OpenAL que voces en el pool
+class SoundPool {
+public:
+    explicit SoundPool(size_t voiceCount = 24, size_t maxPerSound = 4);
+    //False si no hubo voz: todas ocupadas con mas prioridad
+    bool play(const SoundHandle& buffer, float volume = 100.f, int priority = 0);
+    //Tope de voces simultaneas para un sonido puntual (el resto usa el default)
+    void setSoundLimit(ResourceId id, size_t maxVoices);
+    void setDefaultLimit(size_t maxVoices);
+    //Una vez por frame: marca libres las voces que terminaron
+    void update();
+    void stopAll();
+    size_t activeVoices() const;
+    size_t voiceCount() const;
+private:
+    struct Voice {
+        //La voz queda atada a su ultimo buffer: volver a dispararlo no llama a setBuffer
+        SoundHandle buffer;
+        Sound sound;
+        int priority = 0;
+        uint64_t startedAt = 0;
+        bool active = false;
+    };
+    vector<Voice> voices;
+    unordered_map<ResourceId, size_t, ResourceIdHash> limits;
+    size_t defaultLimit;
+    uint64_t playCounter;
+    Voice* pickVoice(ResourceId id, int priority);
+    size_t limitFor(ResourceId id) const;
+};
+
+#endif
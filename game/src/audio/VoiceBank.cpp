@@ -0,0 +1,66 @@
+#include "VoiceBank.h"
+#include "../core/Fnv.h"
+#include <iostream>
+
+VoiceBank::VoiceBank(ResourceManager& res)
+: resources(res),
+  defaultBlip(ResourceId::of("assets/audio/voice_blip.wav"))
+{
+}
+
+void VoiceBank::setDefaultBlip(ResourceId id) {
+    defaultBlip = id;
+}
+
+void VoiceBank::loadConfig(const json& voices) {
+    if (!voices.is_object()){return;}
+    for (auto it = voices.begin(); it != voices.end(); ++it) {
+        const json& v = it.value();
+        if (!v.is_object()){continue;}
+        VoiceProfile profile;
+        if (v.contains("blip")) {
+            profile.blip = ResourceId::of(v["blip"].get<string>());
+        }
+        profile.pitch = v.value("pitch", 1.f);
+        profile.timbre = v.value("timbre", 0.f);
+        setVoice(it.key(), profile);
+    }
+    cout << "[Audio] Voces configuradas: " << profiles.size() << endl;
+}
+
+void VoiceBank::setVoice(const string& speaker, const VoiceProfile& profile) {
+    VoiceProfile p = profile;
+    if (p.pitch <= 0.f){p.pitch = 1.f;}
+    if (p.timbre < -1.f){p.timbre = -1.f;}
+    if (p.timbre > 1.f){p.timbre = 1.f;}
+    profiles[speakerKey(speaker)] = p;
+}
+
+VoiceProfile VoiceBank::profileFor(const string& speaker) const {
+    string key = speakerKey(speaker);
+    auto it = profiles.find(key);
+    VoiceProfile p;
+    if (it != profiles.end()) {
+        p = it->second;
+    } else if (!key.empty()) {
+        //FNV-1a del nombre: la misma voz en cada corrida
+        uint64_t h = fnv1a(key);
+        p.pitch = 0.85f + float(h % 1000) / 1000.f * 0.35f;
+        p.timbre = float((h >> 16) % 1000) / 500.f - 1.f;
+    }
+    if (!p.blip){p.blip = defaultBlip;}
+    return p;
+}
+
+SoundHandle VoiceBank::buffer(ResourceId id) {
+    //Quien lo reproduce guarda el handle: el LRU no lo libera mientras suene
+    return resources.acquireSound(id ? id : defaultBlip);
+}
+
+string VoiceBank::speakerKey(const string& speaker) {
+    //Los json traen " Kami" y "Kami"
+    size_t b = speaker.find_first_not_of(" \t");
+    if (b == string::npos){return string();}
+    size_t e = speaker.find_last_not_of(" \t");
+    return speaker.substr(b, e - b + 1);
+}
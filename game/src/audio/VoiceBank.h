@@ -0,0 +1,42 @@
+#ifndef VOICE_BANK_H
+#define VOICE_BANK_H
+
+#include <SFML/Audio.hpp>
+#include <string>
+#include <unordered_map>
+#include "../core/ResourceManager.h"
+#include "../visualnovel/json.hpp"
+using namespace std;
+using namespace sf;
+using json = nlohmann::json;
+
+//Voz de un personaje: blip base compartido + variante sintetizada al reproducir
+struct VoiceProfile {
+    ResourceId blip;
+    //1 = tono original, 2 = una octava arriba
+    float pitch = 1.f;
+    //-1 mas opaco, 0 original, 1 mas brillante
+    float timbre = 0.f;
+};
+
+//Blips decodificados una sola vez y compartidos por todas las cajas de dialogo
+class VoiceBank {
+public:
+    explicit VoiceBank(ResourceManager& res);
+    //Blip para el narrador y los personajes sin blip propio
+    void setDefaultBlip(ResourceId id);
+    //"voices" de game_config.json: {"Kami": {"blip": "...", "pitch": 1.1, "timbre": 0.3}}
+    void loadConfig(const json& voices);
+    void setVoice(const string& speaker, const VoiceProfile& profile);
+    //Configurada o derivada del nombre: un personaje nuevo suena distinto sin muestras extra
+    VoiceProfile profileFor(const string& speaker) const;
+    //Decodificado la primera vez y compartido; el LRU lo libera cuando nadie tiene el handle
+    SoundHandle buffer(ResourceId id);
+private:
+    ResourceManager& resources;
+    ResourceId defaultBlip;
+    unordered_map<string, VoiceProfile> profiles;
+    static string speakerKey(const string& speaker);
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include "Arena.h"
+#include <new>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+Arena::Arena(size_t blockSize)
+: head(nullptr),
+  cursor(nullptr),
+  end(nullptr),
+  initialBlockSize(max<size_t>(blockSize, 256)),
+  nextBlockSize(initialBlockSize),
+  used(0),
+  blocks(0)
+{
+}
+
+Arena::~Arena() {
+    reset();
+}
+
+void Arena::addBlock(size_t minBytes) {
+    //Cada bloque crece al doble para que una escena grande use pocos
+    size_t size = max(nextBlockSize, minBytes + alignof(max_align_t));
+    char* raw = static_cast<char*>(::operator new(sizeof(Block) + size));
+    Block* block = reinterpret_cast<Block*>(raw);
+    block->next = head;
+    block->size = size;
+    head = block;
+    cursor = raw + sizeof(Block);
+    end = cursor + size;
+    blocks++;
+    nextBlockSize = size * 2;
+}
+
+void* Arena::do_allocate(size_t bytes, size_t alignment) {
+    uintptr_t p = reinterpret_cast<uintptr_t>(cursor);
+    uintptr_t aligned = (p + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    if (!cursor || aligned + bytes > reinterpret_cast<uintptr_t>(end)) {
+        addBlock(bytes + alignment);
+        p = reinterpret_cast<uintptr_t>(cursor);
+        aligned = (p + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    }
+    cursor = reinterpret_cast<char*>(aligned + bytes);
+    used += bytes;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void Arena::do_deallocate(void*, size_t, size_t) {
+    //Nada: la memoria vuelve toda junta en reset()
+}
+
+bool Arena::do_is_equal(const pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+string_view Arena::copy(string_view s) {
+    if (s.empty()){return string_view();}
+    char* p = static_cast<char*>(allocate(s.size(), 1));
+    memcpy(p, s.data(), s.size());
+    return string_view(p, s.size());
+}
+
+void Arena::reserve(size_t bytes) {
+    if (!cursor || static_cast<size_t>(end - cursor) < bytes) {
+        nextBlockSize = max(nextBlockSize, bytes);
+        addBlock(bytes);
+    }
+}
+
+void Arena::reset() {
+    while (head) {
+        Block* next = head->next;
+        ::operator delete(head);
+        head = next;
+    }
+    cursor = nullptr;
+    end = nullptr;
+    nextBlockSize = initialBlockSize;
+    used = 0;
+    blocks = 0;
+}
+
+size_t Arena::bytesUsed() const {
+    return used;
+}
+
+size_t Arena::blockCount() const {
+    return blocks;
+}
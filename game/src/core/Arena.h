@@ -0,0 +1,44 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <string_view>
+#include <memory_resource>
+using namespace std;
+
+//Arena monotona: reserva por bloques y libera todo junto en reset()
+//Se usa como memory_resource para los pmr::vector/unordered_map de una escena
+class Arena : public pmr::memory_resource {
+public:
+    explicit Arena(size_t blockSize = 16 * 1024);
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    //Copia el texto al arena (no agrega '\0')
+    string_view copy(string_view s);
+    //Asegura espacio contiguo para los proximos 'bytes' (un solo bloque)
+    void reserve(size_t bytes);
+    //Libera todos los bloques de una vez
+    void reset();
+    size_t bytesUsed() const;
+    size_t blockCount() const;
+private:
+    struct Block {
+        Block* next;
+        size_t size;
+    };
+    Block* head;
+    char* cursor;
+    char* end;
+    //reset() vuelve al tamaño inicial: si no, cada reuso arranca con el doble
+    size_t initialBlockSize;
+    size_t nextBlockSize;
+    size_t used;
+    size_t blocks;
+    void addBlock(size_t minBytes);
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override;
+};
+
+#endif
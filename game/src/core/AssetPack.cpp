@@ -0,0 +1,181 @@
+#include "AssetPack.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+namespace fs = std::filesystem;
+
+static const char PackMagic[4] = { 'R', 'P', 'A', 'K' };
+
+AssetPack::AssetPack()
+: entries(nullptr),
+  entryCount(0),
+  paths(nullptr)
+{
+}
+
+AssetPack& AssetPack::getInstance() {
+    static AssetPack instance;
+    return instance;
+}
+
+bool AssetPack::open(const string& path, const vector<string>& overrideDirs) {
+    entries = nullptr;
+    entryCount = 0;
+    paths = nullptr;
+    looseFiles.clear();
+    if (!file.open(path)){return false;}
+    const char* base = file.data();
+    size_t size = file.size();
+    PackHeader h;
+    if (size < sizeof(h)) {
+        cerr << "[System] ERROR: " << path << " truncado" << endl;
+        file.close();
+        return false;
+    }
+    memcpy(&h, base, sizeof(h));
+    uint64_t tocEnd = h.tocOffset + uint64_t(h.entryCount) * sizeof(PackEntry);
+    if (memcmp(h.magic, PackMagic, 4) != 0 || h.version != Version || tocEnd > size
+        || h.tocOffset % Alignment != 0) {
+        cerr << "[System] " << path << " no es un .rpak v" << Version << ", se ignora" << endl;
+        file.close();
+        return false;
+    }
+    const PackEntry* toc = reinterpret_cast<const PackEntry*>(base + h.tocOffset);
+    for (uint32_t i = 0; i < h.entryCount; ++i) {
+        if (toc[i].offset + toc[i].size > size || (i > 0 && toc[i - 1].id >= toc[i].id)
+            || h.pathsOffset + toc[i].pathOffset + toc[i].pathLength > size) {
+            cerr << "[System] ERROR: " << path << " corrupto" << endl;
+            file.close();
+            return false;
+        }
+    }
+    entries = toc;
+    entryCount = h.entryCount;
+    paths = base + h.pathsOffset;
+    //Una sola recorrida al iniciar; despues find no toca el disco
+    error_code ec;
+    for (const auto& dir : overrideDirs) {
+        for (fs::recursive_directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->is_regular_file(ec)) {
+                looseFiles.insert(ResourceId::of(it->path().generic_string()));
+            }
+        }
+        ec.clear();
+    }
+    cout << "[System] Pack " << path << ": " << entryCount << " archivos";
+    if (!looseFiles.empty()) {
+        cout << " (" << looseFiles.size() << " sueltos lo pisan)";
+    }
+    cout << endl;
+    return true;
+}
+
+bool AssetPack::isOpen() const {
+    return entries != nullptr;
+}
+
+bool AssetPack::find(ResourceId id, const char*& data, size_t& size) const {
+    if (!entries || !id){return false;}
+    if (looseFiles.count(id)){return false;}
+    const PackEntry* end = entries + entryCount;
+    const PackEntry* it = lower_bound(entries, end, id.hash(), [](const PackEntry& e, uint64_t h) {
+        return e.id < h;
+    });
+    if (it == end || it->id != id.hash()){return false;}
+    data = file.data() + it->offset;
+    size = static_cast<size_t>(it->size);
+    return true;
+}
+
+bool AssetPack::isOverridden(ResourceId id) const {
+    return looseFiles.count(id) > 0;
+}
+
+size_t AssetPack::size() const {
+    return entryCount;
+}
+
+vector<string> AssetPack::list(string_view prefix) const {
+    vector<string> out;
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        string_view path(paths + entries[i].pathOffset, entries[i].pathLength);
+        if (path.substr(0, prefix.size()) == prefix) {
+            out.emplace_back(path);
+        }
+    }
+    return out;
+}
+
+bool AssetPack::write(const string& path, const vector<string>& files) {
+    struct Item {
+        ResourceId id;
+        string source;
+        string name;
+        uint64_t size;
+    };
+    vector<Item> items;
+    for (const auto& f : files) {
+        error_code ec;
+        uint64_t size = fs::file_size(f, ec);
+        if (ec) {
+            cerr << "[System] No se pudo leer " << f << endl;
+            return false;
+        }
+        ResourceId id = ResourceId::of(f);
+        items.push_back(Item{ id, f, string(id.path()), size });
+    }
+    sort(items.begin(), items.end(), [](const Item& a, const Item& b) { return a.id < b.id; });
+    for (size_t i = 1; i < items.size(); ++i) {
+        if (items[i - 1].id == items[i].id) {
+            cerr << "[System] ERROR: ruta repetida en el pack: " << items[i].name << endl;
+            return false;
+        }
+    }
+    ofstream out(path, ios::binary);
+    if (!out){return false;}
+    auto pad = [&](uint64_t& pos) {
+        static const char zeros[Alignment] = {};
+        uint64_t aligned = (pos + Alignment - 1) / Alignment * Alignment;
+        out.write(zeros, aligned - pos);
+        pos = aligned;
+    };
+    PackHeader h = {};
+    memcpy(h.magic, PackMagic, 4);
+    h.version = Version;
+    h.entryCount = static_cast<uint32_t>(items.size());
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    uint64_t pos = sizeof(h);
+    vector<PackEntry> toc;
+    string paths;
+    vector<char> buffer;
+    for (const auto& item : items) {
+        pad(pos);
+        ifstream in(item.source, ios::binary);
+        buffer.resize(static_cast<size_t>(item.size));
+        if (!in.read(buffer.data(), buffer.size())) {
+            cerr << "[System] No se pudo leer " << item.source << endl;
+            return false;
+        }
+        out.write(buffer.data(), buffer.size());
+        PackEntry e = {};
+        e.id = item.id.hash();
+        e.offset = pos;
+        e.size = item.size;
+        e.pathOffset = static_cast<uint32_t>(paths.size());
+        e.pathLength = static_cast<uint32_t>(item.name.size());
+        paths += item.name;
+        toc.push_back(e);
+        pos += item.size;
+    }
+    pad(pos);
+    h.tocOffset = pos;
+    out.write(reinterpret_cast<const char*>(toc.data()), toc.size() * sizeof(PackEntry));
+    pos += toc.size() * sizeof(PackEntry);
+    h.pathsOffset = pos;
+    out.write(paths.data(), paths.size());
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    return static_cast<bool>(out);
+}
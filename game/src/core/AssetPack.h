@@ -0,0 +1,83 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <cstdint>
+#include "MappedFile.h"
+#include "ResourceId.h"
+using namespace std;
+
+//Formato .rpak: cabecera + datos alineados + TOC ordenada por id + rutas (para listar)
+#pragma pack(push, 1)
+struct PackHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t entryCount;
+    uint64_t tocOffset;
+    uint64_t pathsOffset;
+};
+
+struct PackEntry {
+    uint64_t id;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t pathOffset;
+    uint32_t pathLength;
+};
+#pragma pack(pop)
+
+//Todos los assets en un solo archivo mapeado al iniciar: una apertura en vez de cientos
+//Los archivos sueltos en las carpetas de override ganan sobre el pack (mods, desarrollo)
+class AssetPack {
+public:
+    static const uint16_t Version = 1;
+    static const uint32_t Alignment = 16;
+    static AssetPack& getInstance();
+    //Mapea el pack y anota que archivos sueltos lo pisan. Llamar una vez antes de cargar nada
+    bool open(const string& path, const vector<string>& overrideDirs = { "assets", "data" });
+    bool isOpen() const;
+    //Bytes del asset dentro del mapeo; false si no esta o si hay un archivo suelto que gana
+    bool find(ResourceId id, const char*& data, size_t& size) const;
+    //Hay un archivo suelto con esa ruta en las carpetas de override (este o no en el pack)
+    bool isOverridden(ResourceId id) const;
+    size_t size() const;
+    //Rutas empaquetadas que empiezan con prefix (para recorrer carpetas que solo estan en el pack)
+    vector<string> list(string_view prefix) const;
+    //Arma un pack con estos archivos (rutas relativas a la carpeta del juego)
+    static bool write(const string& path, const vector<string>& files);
+private:
+    AssetPack();
+    MappedFile file;
+    const PackEntry* entries;
+    uint32_t entryCount;
+    const char* paths;
+    unordered_set<ResourceId, ResourceIdHash> looseFiles;
+};
+
+//Carga del pack con loadFromMemory (sin copiar el archivo) o del disco si no esta empaquetado
+//Sirve para Image, Texture, Font y SoundBuffer (las Font leen del mapeo mientras vivan)
+template <typename Resource>
+bool loadAsset(Resource& resource, ResourceId id) {
+    const char* data = nullptr;
+    size_t size = 0;
+    if (AssetPack::getInstance().find(id, data, size)) {
+        return resource.loadFromMemory(data, size);
+    }
+    return resource.loadFromFile(string(id.path()));
+}
+
+//Igual para Music: va leyendo del mapeo mientras suena (stream en memoria, sin copia)
+template <typename Stream>
+bool openAsset(Stream& stream, ResourceId id) {
+    const char* data = nullptr;
+    size_t size = 0;
+    if (AssetPack::getInstance().find(id, data, size)) {
+        return stream.openFromMemory(data, size);
+    }
+    return stream.openFromFile(string(id.path()));
+}
+
+#endif
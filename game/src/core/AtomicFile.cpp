@@ -0,0 +1,34 @@
+#include "AtomicFile.h"
+#include <sstream>
+#include <thread>
+#include <filesystem>
+namespace fs = std::filesystem;
+
+bool writeFileAtomic(const string& path, const function<void(ofstream&)>& write) {
+    error_code ec;
+    fs::path parent = fs::path(path).parent_path();
+    if (!parent.empty()) {
+        fs::create_directories(parent, ec);
+    }
+    //Un temporal por hilo: dos workers guardando lo mismo no se pisan
+    ostringstream tmpName;
+    tmpName << path << '.' << this_thread::get_id() << ".tmp";
+    string tmp = tmpName.str();
+    {
+        ofstream f(tmp, ios::binary | ios::trunc);
+        if (!f.is_open()){return false;}
+        write(f);
+        if (!f.good()) {
+            f.close();
+            fs::remove(tmp, ec);
+            return false;
+        }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        //En Windows falla si otro lo tiene mapeado; queda el que estaba
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
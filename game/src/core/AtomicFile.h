@@ -0,0 +1,13 @@
+#ifndef ATOMIC_FILE_H
+#define ATOMIC_FILE_H
+
+#include <string>
+#include <fstream>
+#include <functional>
+using namespace std;
+
+//Escribe en un temporal junto a path y lo renombra al final: nadie lee (ni mapea) un archivo
+//a medio escribir. Crea la carpeta si hace falta. false si write falla o no se pudo reemplazar
+bool writeFileAtomic(const string& path, const function<void(ofstream&)>& write);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef FNV_H
+#define FNV_H
+
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+//FNV-1a de 64 bits: ids de recursos, claves de las caches y hashes de contenido
+const uint64_t FnvOffset = 14695981039346656037ull;
+const uint64_t FnvPrime = 1099511628211ull;
+
+//Byte a byte; h para seguir un hash ya empezado
+inline uint64_t fnv1a(const void* data, size_t size, uint64_t h = FnvOffset) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        h = (h ^ p[i]) * FnvPrime;
+    }
+    return h;
+}
+
+inline uint64_t fnv1a(string_view s, uint64_t h = FnvOffset) {
+    return fnv1a(s.data(), s.size(), h);
+}
+
+//Un valor entero de una vez (tamaños, codepoints, otros hashes)
+inline uint64_t fnv1aMix(uint64_t h, uint64_t value) {
+    return (h ^ value) * FnvPrime;
+}
+
+#endif
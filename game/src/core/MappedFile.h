@@ -0,0 +1,30 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+using namespace std;
+
+//Archivo de solo lectura mapeado en memoria (Windows/POSIX)
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    //Mapea el archivo completo
+    bool open(const string& path);
+    void close();
+    bool isOpen() const;
+    const char* data() const;
+    size_t size() const;
+private:
+    const char* ptr;
+    size_t length;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mapHandle;
+#endif
+};
+
+#endif
@@ -0,0 +1,89 @@
+#include "RawImageCache.h"
+#include "AtomicFile.h"
+#include "Fnv.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <filesystem>
+namespace fs = std::filesystem;
+
+static const char RawMagic[4] = { 'R', 'R', 'A', 'W' };
+
+RawImageCache::RawImageCache() {}
+
+bool RawImageCache::setDirectory(const string& dir) {
+    directory.clear();
+    if (dir.empty()){return true;}
+    error_code ec;
+    fs::create_directories(dir, ec);
+    if (!fs::is_directory(dir, ec)) {
+        cerr << "[Resources] ERROR: no se pudo crear la cache de texturas: " << dir << endl;
+        return false;
+    }
+    directory = dir;
+    return true;
+}
+
+bool RawImageCache::isEnabled() const {
+    return !directory.empty();
+}
+
+string RawImageCache::blobPath(ResourceId source, unsigned variant) const {
+    ostringstream name;
+    name << directory << '/' << hex << setw(16) << setfill('0') << source.hash() << '-' << variant << ".rgba";
+    return name.str();
+}
+
+bool RawImageCache::load(ResourceId source, unsigned variant, uint64_t hash, RawImage& out) const {
+    if (directory.empty()){return false;}
+    if (!out.file.open(blobPath(source, variant))){return false;}
+    RawImageHeader h;
+    if (out.file.size() < sizeof(h)) {
+        out.file.close();
+        return false;
+    }
+    memcpy(&h, out.file.data(), sizeof(h));
+    uint64_t expected = sizeof(h) + uint64_t(h.width) * h.height * 4;
+    if (memcmp(h.magic, RawMagic, 4) != 0 || h.version != Version || h.contentHash != hash
+        || out.file.size() != expected || h.scale == 0) {
+        //Viejo o roto: el proximo decode lo reescribe
+        out.file.close();
+        return false;
+    }
+    out.size = Vector2u(h.width, h.height);
+    out.pixels = reinterpret_cast<const Uint8*>(out.file.data() + sizeof(h));
+    out.scale = float(h.scale);
+    return true;
+}
+
+bool RawImageCache::store(ResourceId source, unsigned variant, uint64_t hash, const Image& image, unsigned scale) const {
+    if (directory.empty()){return false;}
+    Vector2u size = image.getSize();
+    if (size.x == 0 || size.y == 0){return false;}
+    RawImageHeader h;
+    memcpy(h.magic, RawMagic, 4);
+    h.version = Version;
+    h.contentHash = hash;
+    h.width = size.x;
+    h.height = size.y;
+    h.scale = scale;
+    h.reserved = 0;
+    return writeFileAtomic(blobPath(source, variant), [&](ofstream& f) {
+        f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        f.write(reinterpret_cast<const char*>(image.getPixelsPtr()), streamsize(size_t(size.x) * size.y * 4));
+    });
+}
+
+uint64_t RawImageCache::contentHash(const char* data, size_t size) {
+    //FNV-1a sobre palabras de 8 bytes + la cola byte a byte
+    uint64_t h = FnvOffset;
+    size_t words = size / 8;
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t w;
+        memcpy(&w, data + i * 8, 8);
+        h = fnv1aMix(h, w);
+    }
+    h = fnv1a(data + words * 8, size - words * 8, h);
+    return h ^ uint64_t(size);
+}
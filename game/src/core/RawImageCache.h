@@ -0,0 +1,55 @@
+#ifndef RAW_IMAGE_CACHE_H
+#define RAW_IMAGE_CACHE_H
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <cstdint>
+#include "MappedFile.h"
+#include "ResourceId.h"
+using namespace std;
+using namespace sf;
+
+//Blob .rgba: cabecera + pixeles RGBA tal cual los pide Texture::update
+#pragma pack(push, 1)
+struct RawImageHeader {
+    char magic[4];
+    uint32_t version;
+    //Hash del png del que salio: si el png cambia el blob queda viejo
+    uint64_t contentHash;
+    uint32_t width;
+    uint32_t height;
+    //Pixeles del png por pixel del blob (reducido por tier)
+    uint32_t scale;
+    uint32_t reserved;
+};
+#pragma pack(pop)
+
+//Blob mapeado: los pixeles se suben a la GPU directo desde el mapeo
+struct RawImage {
+    MappedFile file;
+    Vector2u size;
+    const Uint8* pixels = nullptr;
+    float scale = 1.f;
+};
+
+//Pngs ya decodificados en disco: cargar uno es mapear el archivo, sin inflar zlib
+//Un blob por asset y variante de tier; se reescribe cuando el hash del png no coincide
+class RawImageCache {
+public:
+    static const uint32_t Version = 1;
+    RawImageCache();
+    //Carpeta de los blobs (se crea si no existe); vacia desactiva la cache
+    bool setDirectory(const string& dir);
+    bool isEnabled() const;
+    //False si no hay blob o si es de otra version del png
+    bool load(ResourceId source, unsigned variant, uint64_t contentHash, RawImage& out) const;
+    //Seguro desde cualquier hilo (cada blob se escribe aparte y se renombra al terminar)
+    bool store(ResourceId source, unsigned variant, uint64_t contentHash, const Image& image, unsigned scale) const;
+    //Hash de los bytes del png (de a 8 bytes: no pesa al lado del decode)
+    static uint64_t contentHash(const char* data, size_t size);
+private:
+    string directory;
+    string blobPath(ResourceId source, unsigned variant) const;
+};
+
+#endif
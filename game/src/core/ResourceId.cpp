@@ -0,0 +1,78 @@
+#include "ResourceId.h"
+#include "StringPool.h"
+#include "Fnv.h"
+#include <iostream>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+namespace {
+
+uint64_t pathHash(string_view s) {
+    uint64_t h = fnv1a(s);
+    //El 0 queda reservado para el id vacio
+    return h ? h : 1;
+}
+
+//Hash -> ruta, para poder cargar a partir del id. El texto vive en la NameTable
+struct PathRegistry {
+    mutex registryMutex;
+    unordered_map<uint64_t, string_view> paths;
+};
+
+PathRegistry& registry() {
+    static PathRegistry instance;
+    return instance;
+}
+
+}
+
+string normalizeResourcePath(string_view path) {
+    vector<string_view> parts;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find_first_of("/\\", start);
+        if (end == string_view::npos){end = path.size();}
+        string_view part = path.substr(start, end - start);
+        if (part == "..") {
+            if (!parts.empty() && parts.back() != "..") {
+                parts.pop_back();
+            } else {
+                parts.push_back(part);
+            }
+        } else if (!part.empty() && part != ".") {
+            parts.push_back(part);
+        }
+        start = end + 1;
+    }
+    string out;
+    if (!path.empty() && (path[0] == '/' || path[0] == '\\')){out += '/';}
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (i > 0){out += '/';}
+        out.append(parts[i].data(), parts[i].size());
+    }
+    return out;
+}
+
+ResourceId ResourceId::of(string_view path) {
+    if (path.empty()){return ResourceId();}
+    string normalized = normalizeResourcePath(path);
+    uint64_t h = pathHash(normalized);
+    PathRegistry& reg = registry();
+    lock_guard<mutex> lock(reg.registryMutex);
+    auto it = reg.paths.find(h);
+    if (it == reg.paths.end()) {
+        reg.paths.emplace(h, NameTable::getInstance().intern(normalized));
+    } else if (it->second != normalized) {
+        cerr << "[Resources] Colision de hash: " << it->second << " / " << normalized << endl;
+    }
+    return ResourceId(h);
+}
+
+string_view ResourceId::path() const {
+    if (!value){return string_view();}
+    PathRegistry& reg = registry();
+    lock_guard<mutex> lock(reg.registryMutex);
+    auto it = reg.paths.find(value);
+    return it != reg.paths.end() ? it->second : string_view();
+}
@@ -0,0 +1,36 @@
+#ifndef RESOURCE_ID_H
+#define RESOURCE_ID_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+using namespace std;
+
+//Identidad estable de un asset: hash FNV-1a de su ruta normalizada
+//Se calcula una vez (al cargar la escena o al construir el menu) y despues solo se compara el numero
+class ResourceId {
+public:
+    ResourceId() : value(0) {}
+    //Normaliza la ruta, la hashea y la registra para poder cargarla despues
+    static ResourceId of(string_view path);
+    uint64_t hash() const { return value; }
+    //Ruta normalizada registrada ("" si el id es vacio)
+    string_view path() const;
+    explicit operator bool() const { return value != 0; }
+    bool operator==(ResourceId other) const { return value == other.value; }
+    bool operator!=(ResourceId other) const { return value != other.value; }
+    bool operator<(ResourceId other) const { return value < other.value; }
+private:
+    explicit ResourceId(uint64_t v) : value(v) {}
+    uint64_t value;
+};
+
+//El id ya es un hash: se usa tal cual en los unordered_map
+struct ResourceIdHash {
+    size_t operator()(ResourceId id) const { return static_cast<size_t>(id.hash()); }
+};
+
+//"assets\\images/./bg/../bg/a.png" -> "assets/images/bg/a.png"
+string normalizeResourcePath(string_view path);
+
+#endif
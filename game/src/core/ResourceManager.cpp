@@ -1,31 +1,680 @@
 #include "ResourceManager.h"
+#include "AssetPack.h"
+#include "../graphics/TextLayout.h"
+#include "../graphics/GlyphWarmup.h"
+#include <algorithm>
+#include <filesystem>
 
-Texture& ResourceManager::getTexture(const string& path) {
-    if (!textures.count(path)) {
-        textures[path] = Texture();
-        if (!textures[path].loadFromFile(path)) {
-            cout << "ERROR: No se pudo cargar textura: " << path << endl;
+//Reloj logico del LRU: cada acquire/release marca el uso
+static uint64_t useClock = 0;
+
+//Reduce a la mitad promediando bloques de 2x2 (false si ya no se puede achicar)
+static bool halveImage(Image& image) {
+    Vector2u size = image.getSize();
+    unsigned w = size.x / 2;
+    unsigned h = size.y / 2;
+    if (w == 0 || h == 0){return false;}
+    const Uint8* src = image.getPixelsPtr();
+    size_t stride = size_t(size.x) * 4;
+    vector<Uint8> dst(size_t(w) * h * 4);
+    for (unsigned y = 0; y < h; ++y) {
+        const Uint8* row0 = src + size_t(y) * 2 * stride;
+        const Uint8* row1 = row0 + stride;
+        Uint8* out = &dst[size_t(y) * w * 4];
+        for (unsigned x = 0; x < w * 4; ++x) {
+            //Mismo canal del pixel vecino: 4 bytes mas adelante
+            unsigned i = (x / 4) * 8 + x % 4;
+            out[x] = Uint8((row0[i] + row0[i + 4] + row1[i] + row1[i + 4] + 2) / 4);
+        }
+    }
+    image.create(w, h, dst.data());
+    return true;
+}
+
+//"bg/park.png" -> "bg/park@half.png"
+static string tierVariantPath(string_view path, TextureTier tier) {
+    size_t dot = path.rfind('.');
+    if (dot == string_view::npos || path.find('/', dot) != string_view::npos){dot = path.size();}
+    string out(path.substr(0, dot));
+    out += tier == TextureTier::Half ? "@half" : "@quarter";
+    out += path.substr(dot);
+    return out;
+}
+
+void ResourceEntry::acquire() {
+    ++refs;
+    lastUse = ++useClock;
+}
+
+void ResourceEntry::release() {
+    --refs;
+    lastUse = ++useClock;
+}
+
+const Texture& TextureHandle::get() const {
+    //Vacia: un sprite con esta textura no dibuja nada
+    static const Texture placeholder;
+    return ready() ? entry->texture : placeholder;
+}
+
+ResourceManager::ResourceManager()
+: stopping(false),
+  uploadBudget(milliseconds(4)),
+  textureTier(TextureTier::Full),
+  textureGeneration(0),
+  textureBudget(256u << 20),
+  soundBudget(64u << 20),
+  textureBytes(0),
+  soundBytes(0),
+  atlasBytes(0),
+  textureScanClock(0),
+  soundScanClock(0)
+{
+    //Un hilo para la logica/render, el resto (max 2) decodifica
+    unsigned count = thread::hardware_concurrency();
+    count = count > 2 ? 2 : 1;
+    for (unsigned i = 0; i < count; ++i) {
+        decodeWorkers.emplace_back(&ResourceManager::decodeLoop, this);
+    }
+}
+
+ResourceManager::~ResourceManager() {
+    {
+        lock_guard<mutex> lock(preloadMutex);
+        stopping = true;
+        decodeJobs.clear();
+    }
+    jobReady.notify_all();
+    for (auto& worker : decodeWorkers) {
+        worker.join();
+    }
+}
+
+Texture& ResourceManager::getTexture(ResourceId id) {
+    TextureEntry& entry = textures[id];
+    entry.id = id;
+    //Quien llama guarda la referencia: queda fuera del LRU
+    entry.pinned = true;
+    loadTextureNow(entry);
+    return entry.texture;
+}
+
+TextureHandle ResourceManager::acquireTexture(ResourceId id) {
+    if (!id){return TextureHandle();}
+    TextureEntry& entry = textures[id];
+    entry.id = id;
+    loadTextureNow(entry);
+    return TextureHandle(&entry);
+}
+
+void ResourceManager::loadTextureNow(TextureEntry& entry) {
+    if (entry.state != ResourceState::Loading){return;}
+    //Si un worker ya la decodifico, solo falta subirla
+    DecodedImage image;
+    bool failed = false;
+    if (!takePreloadedImage(entry.id, image, failed)) {
+        decodeImage(entry.id, image);
+    }
+    finishTexture(entry, image);
+}
+
+Font& ResourceManager::getFont(ResourceId id) {
+    auto it = fonts.find(id);
+    if (it == fonts.end()) {
+        it = fonts.emplace(id, Font()).first;
+        if (!loadAsset(it->second, id)) {
+            cout << "ERROR: No se pudo cargar fuente: " << id.path() << endl;
+        }
+    }
+    return it->second;
+}
+
+SoundBuffer& ResourceManager::getSound(ResourceId id) {
+    SoundEntry& entry = sounds[id];
+    entry.id = id;
+    entry.pinned = true;
+    loadSoundNow(entry);
+    return *entry.buffer;
+}
+
+SoundHandle ResourceManager::acquireSound(ResourceId id) {
+    if (!id){return SoundHandle();}
+    SoundEntry& entry = sounds[id];
+    entry.id = id;
+    loadSoundNow(entry);
+    return SoundHandle(&entry);
+}
+
+void ResourceManager::loadSoundNow(SoundEntry& entry) {
+    if (entry.state != ResourceState::Loading){return;}
+    unique_ptr<SoundBuffer> buffer;
+    bool failed = false;
+    takePreloadedSound(entry.id, buffer, failed);
+    if (!buffer) {
+        buffer = make_unique<SoundBuffer>();
+        if (!loadAsset(*buffer, entry.id)) {
+            buffer.reset();
+        }
+    }
+    finishSound(entry, move(buffer));
+}
+
+TextureHandle ResourceManager::loadTextureAsync(ResourceId id) {
+    if (!id){return TextureHandle();}
+    auto it = textures.find(id);
+    if (it != textures.end()) {
+        return TextureHandle(&it->second);
+    }
+    TextureEntry& entry = textures[id];
+    entry.id = id;
+    //Ya decodificada (precarga): subirla ahora cuesta poco y evita un frame sin textura
+    DecodedImage image;
+    bool failed = false;
+    if (takePreloadedImage(id, image, failed)) {
+        finishTexture(entry, image);
+        return TextureHandle(&entry);
+    }
+    pendingTextures.push_back(id);
+    enqueueDecode(id, false);
+    return TextureHandle(&entry);
+}
+
+SoundHandle ResourceManager::loadSoundAsync(ResourceId id) {
+    if (!id){return SoundHandle();}
+    auto it = sounds.find(id);
+    if (it != sounds.end()) {
+        return SoundHandle(&it->second);
+    }
+    SoundEntry& entry = sounds[id];
+    entry.id = id;
+    unique_ptr<SoundBuffer> buffer;
+    bool failed = false;
+    if (takePreloadedSound(id, buffer, failed)) {
+        finishSound(entry, move(buffer));
+        return SoundHandle(&entry);
+    }
+    pendingSounds.push_back(id);
+    enqueueDecode(id, true);
+    return SoundHandle(&entry);
+}
+
+bool ResourceManager::buildAtlas(const vector<ResourceId>& ids) {
+    size_t packed = 0;
+    for (ResourceId id : ids) {
+        DecodedImage image;
+        bool failed = false;
+        if (!takePreloadedImage(id, image, failed) || !image.image) {
+            if (image.raw) {
+                //El atlas copia pixeles: el blob se pasa a una Image
+                image.image = make_unique<Image>();
+                image.image->create(image.raw->size.x, image.raw->size.y, image.raw->pixels);
+            } else {
+                image.image = make_unique<Image>();
+                if (!loadAsset(*image.image, id)) {
+                    cout << "ERROR: No se pudo cargar imagen para el atlas: " << id.path() << endl;
+                    continue;
+                }
+            }
+        }
+        //Lo que no entra en una pagina se sigue cargando suelto
+        if (atlas.add(id, *image.image)) {
+            packed++;
         }
     }
-    return textures[path];
+    size_t before = atlas.bytes();
+    bool ok = atlas.build();
+    atlasBytes += atlas.bytes() - before;
+    cout << "[Resources] Atlas: " << packed << " imagenes en " << atlas.pageCount()
+         << " paginas (" << atlas.bytes() / 1024 << " KB)" << endl;
+    return ok;
+}
+
+AtlasRegion ResourceManager::getRegion(ResourceId id) {
+    AtlasRegion region = atlas.find(id);
+    return region ? region : wholeTexture(getTexture(id));
+}
+
+AtlasRegion ResourceManager::findRegion(ResourceId id) const {
+    return atlas.find(id);
+}
+
+uint64_t ResourceManager::getFontHash(ResourceId fontId) {
+    auto it = fontHashes.find(fontId);
+    if (it != fontHashes.end()){return it->second;}
+    //Del pack o del archivo suelto que lo pisa: el mismo que carga getFont
+    const char* data = nullptr;
+    size_t size = 0;
+    MappedFile file;
+    if (!AssetPack::getInstance().find(fontId, data, size) && file.open(string(fontId.path()))) {
+        data = file.data();
+        size = file.size();
+    }
+    uint64_t hash = data ? RawImageCache::contentHash(data, size) : 0;
+    fontHashes[fontId] = hash;
+    return hash;
+}
+
+bool ResourceManager::buildGlyphAtlas(ResourceId fontId, const vector<unsigned>& sizes, const vector<Uint32>& extra, const string& cachePath) {
+    Font& font = getFont(fontId);
+    //Hash del ttf: si la fuente cambia, el atlas guardado no sirve
+    uint64_t hash = getFontHash(fontId);
+    if (!hash) {
+        cout << "ERROR: No se pudo leer la fuente para el atlas de glifos: " << fontId.path() << endl;
+        return false;
+    }
+    unique_ptr<GlyphAtlas> glyphs = make_unique<GlyphAtlas>();
+    if (!glyphs->build(font, hash, sizes, extra, cachePath)) {
+        return false;
+    }
+    //El corte de lineas mide con los avances del atlas: no le pide nada a la Font
+    for (unsigned s : glyphs->characterSizes()) {
+        GlyphMetrics::get(font, s).prime(*glyphs);
+    }
+    GlyphWarmup::getInstance().addWarmed(glyphs->glyphCount());
+    atlasBytes += size_t(glyphs->getTexture().getSize().x) * glyphs->getTexture().getSize().y * 4;
+    glyphAtlases[fontId] = move(glyphs);
+    return true;
+}
+
+const GlyphAtlas* ResourceManager::findGlyphAtlas(ResourceId fontId) const {
+    auto it = glyphAtlases.find(fontId);
+    return it == glyphAtlases.end() ? nullptr : it->second.get();
 }
 
-Font& ResourceManager::getFont(const string& path) {
-    if (!fonts.count(path)) {
-        fonts[path] = Font();
-        if (!fonts[path].loadFromFile(path)) {
-            cout << "ERROR: No se pudo cargar fuente: " << path << endl;
+void ResourceManager::update() {
+    if (!pendingTextures.empty() || !pendingSounds.empty()) {
+        uploadPending();
+    }
+    evictUnused(textures, textureBytes, textureBudget, textureScanClock, "textura");
+    evictUnused(sounds, soundBytes, soundBudget, soundScanClock, "sonido");
+}
+
+void ResourceManager::uploadPending() {
+    Clock frameClock;
+    for (size_t i = 0; i < pendingTextures.size();) {
+        ResourceId id = pendingTextures[i];
+        TextureEntry& entry = textures[id];
+        if (entry.state != ResourceState::Loading) {
+            //La cargo getTexture mientras tanto
+            pendingTextures.erase(pendingTextures.begin() + i);
+            continue;
+        }
+        //Tope por frame: siempre al menos una subida
+        if (i > 0 && frameClock.getElapsedTime() >= uploadBudget){break;}
+        DecodedImage image;
+        bool failed = false;
+        if (!takePreloadedImage(id, image, failed) && !failed) {
+            ++i;
+            continue;
+        }
+        finishTexture(entry, image);
+        pendingTextures.erase(pendingTextures.begin() + i);
+    }
+    for (size_t i = 0; i < pendingSounds.size();) {
+        ResourceId id = pendingSounds[i];
+        SoundEntry& entry = sounds[id];
+        if (entry.state != ResourceState::Loading) {
+            pendingSounds.erase(pendingSounds.begin() + i);
+            continue;
+        }
+        unique_ptr<SoundBuffer> buffer;
+        bool failed = false;
+        if (!takePreloadedSound(id, buffer, failed) && !failed) {
+            ++i;
+            continue;
         }
+        finishSound(entry, move(buffer));
+        pendingSounds.erase(pendingSounds.begin() + i);
+    }
+}
+
+bool ResourceManager::uploadTexture(TextureEntry& entry, const DecodedImage& image) {
+    bool ok = false;
+    if (image.raw) {
+        //Del mapeo a la GPU, sin pasar por una Image
+        ok = entry.texture.create(image.raw->size.x, image.raw->size.y);
+        if (ok){entry.texture.update(image.raw->pixels);}
+    } else if (image.image) {
+        ok = entry.texture.loadFromImage(*image.image);
     }
-    return fonts[path];
+    if (!ok){return false;}
+    textureBytes -= entry.bytes;
+    entry.scale = image.scale;
+    Vector2u size = entry.texture.getSize();
+    entry.bytes = size_t(size.x) * size.y * 4;
+    textureBytes += entry.bytes;
+    return true;
 }
 
-SoundBuffer& ResourceManager::getSound(const string& path) {
-    if (!sounds.count(path)) {
-        sounds[path] = SoundBuffer();
-        if (!sounds[path].loadFromFile(path)) {
-            cout << "ERROR: No se pudo cargar sonido: " << path << endl;
+void ResourceManager::finishTexture(TextureEntry& entry, const DecodedImage& image) {
+    if (uploadTexture(entry, image)) {
+        entry.state = ResourceState::Ready;
+    } else {
+        cout << "ERROR: No se pudo cargar textura: " << entry.id.path() << endl;
+        entry.state = ResourceState::Failed;
+    }
+    markResident(entry.id);
+    finishRequest(entry.id);
+}
+
+void ResourceManager::finishSound(SoundEntry& entry, unique_ptr<SoundBuffer> buffer) {
+    if (buffer) {
+        entry.bytes = size_t(buffer->getSampleCount()) * sizeof(Int16);
+        soundBytes += entry.bytes;
+        entry.buffer = move(buffer);
+        entry.state = ResourceState::Ready;
+    } else {
+        //Buffer vacio: getSound siempre devuelve algo reproducible (en silencio)
+        cout << "ERROR: No se pudo cargar sonido: " << entry.id.path() << endl;
+        entry.buffer = make_unique<SoundBuffer>();
+        entry.state = ResourceState::Failed;
+    }
+    markResident(entry.id);
+    finishRequest(entry.id);
+}
+
+template <typename Entries>
+void ResourceManager::evictUnused(Entries& entries, size_t& used, size_t budget, uint64_t& scanClock, const char* kind) {
+    //Sin acquire/release desde la ultima pasada vacia: lo fijado sigue sin poder liberarse
+    if (used <= budget || scanClock == useClock){return;}
+    //Candidatos: sin handles, sin pin y ya terminados
+    vector<typename Entries::iterator> unused;
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        const auto& e = it->second;
+        if (e.refs == 0 && !e.pinned && e.state != ResourceState::Loading) {
+            unused.push_back(it);
         }
     }
-    return sounds[path];
+    sort(unused.begin(), unused.end(), [](const auto& a, const auto& b) {
+        return a->second.lastUse < b->second.lastUse;
+    });
+    for (auto it : unused) {
+        if (used <= budget){break;}
+        used -= it->second.bytes;
+        cout << "[Resources] Liberada " << kind << " (" << it->second.bytes / 1024 << " KB): " << it->first.path() << endl;
+        forgetResident(it->first);
+        entries.erase(it);
+    }
+    scanClock = used > budget ? useClock : 0;
+}
+
+void ResourceManager::setUploadBudget(Time budget) {
+    uploadBudget = budget;
+}
+
+void ResourceManager::setTextureBudget(size_t bytes) {
+    textureBudget = bytes;
+}
+
+void ResourceManager::setSoundBudget(size_t bytes) {
+    soundBudget = bytes;
+}
+
+size_t ResourceManager::getTextureBytes() const {
+    return textureBytes;
+}
+
+size_t ResourceManager::getAtlasBytes() const {
+    return atlasBytes;
+}
+
+size_t ResourceManager::getSoundBytes() const {
+    return soundBytes;
+}
+
+void ResourceManager::setTieredPaths(const vector<string>& prefixes) {
+    tieredPaths.clear();
+    for (const auto& p : prefixes) {
+        tieredPaths.push_back(normalizeResourcePath(p));
+    }
+}
+
+void ResourceManager::setTextureTier(TextureTier tier) {
+    if (textureTier.exchange(tier) == tier){return;}
+    const char* names[] = { "full", "half", "quarter" };
+    cout << "[Resources] Tier de texturas: " << names[int(tier)] << endl;
+    retierTextures();
+}
+
+void ResourceManager::retierTextures() {
+    if (tieredPaths.empty()){return;}
+    size_t freed = 0;
+    size_t reloaded = 0;
+    for (auto it = textures.begin(); it != textures.end();) {
+        TextureEntry& entry = it->second;
+        if (entry.state != ResourceState::Ready || !isTiered(entry.id)) {
+            ++it;
+            continue;
+        }
+        if (entry.refs == 0 && !entry.pinned) {
+            //Nadie la usa: el proximo pedido la carga al tier nuevo
+            textureBytes -= entry.bytes;
+            forgetResident(entry.id);
+            it = textures.erase(it);
+            freed++;
+            continue;
+        }
+        //En uso: mismo Texture (los sprites siguen apuntando a el), otro tamaño
+        DecodedImage image;
+        if (decodeImage(entry.id, image) && uploadTexture(entry, image)) {
+            reloaded++;
+        }
+        ++it;
+    }
+    //Lo precargado a otro tier y que nadie pidio se vuelve a decodificar si hace falta
+    {
+        lock_guard<mutex> lock(preloadMutex);
+        for (auto it = preloadedImages.begin(); it != preloadedImages.end();) {
+            it = isTiered(it->first) && !requestedIds.count(it->first) ? preloadedImages.erase(it) : next(it);
+        }
+    }
+    if (reloaded > 0){textureGeneration++;}
+    cout << "[Resources] Cambio de tier: " << reloaded << " texturas recargadas, " << freed << " liberadas" << endl;
+}
+
+unsigned ResourceManager::getTextureGeneration() const {
+    return textureGeneration;
+}
+
+TextureTier ResourceManager::getTextureTier() const {
+    return textureTier;
+}
+
+TextureTier ResourceManager::tierFor(Vector2u windowSize, bool memorySaver) {
+    //Los fondos son de 1920x1080: en una ventana de la mitad el detalle extra no se ve
+    float ratio = min(windowSize.x / 1920.f, windowSize.y / 1080.f);
+    int tier = ratio > 0.5f ? 0 : (ratio > 0.25f ? 1 : 2);
+    if (memorySaver && tier < 2){++tier;}
+    return TextureTier(tier);
+}
+
+float ResourceManager::getTextureScale(ResourceId id) const {
+    auto it = textures.find(id);
+    return it != textures.end() && it->second.state == ResourceState::Ready ? it->second.scale : 1.f;
+}
+
+unsigned ResourceManager::tierShift(ResourceId id) const {
+    TextureTier tier = textureTier;
+    if (tier == TextureTier::Full || !isTiered(id)){return 0;}
+    return tier == TextureTier::Half ? 1 : 2;
+}
+
+bool ResourceManager::isTiered(ResourceId id) const {
+    string_view path = id.path();
+    for (const auto& prefix : tieredPaths) {
+        if (path.compare(0, prefix.size(), prefix) == 0){return true;}
+    }
+    return false;
+}
+
+bool ResourceManager::setRawCacheDirectory(const string& dir) {
+    return rawCache.setDirectory(dir);
+}
+
+bool ResourceManager::decodeImage(ResourceId id, DecodedImage& out) {
+    out.image.reset();
+    out.raw.reset();
+    out.scale = 1.f;
+    unsigned shift = tierShift(id);
+    ResourceId source = id;
+    const char* data = nullptr;
+    size_t size = 0;
+    if (shift > 0) {
+        //Variante hecha offline junto a la original (o en el pack)
+        ResourceId variant = ResourceId::of(tierVariantPath(id.path(), shift == 1 ? TextureTier::Half : TextureTier::Quarter));
+        error_code ec;
+        if (AssetPack::getInstance().find(variant, data, size) || filesystem::exists(string(variant.path()), ec)) {
+            source = variant;
+            out.scale = float(1u << shift);
+            shift = 0;
+        }
+    }
+    //Bytes del png: del pack o mapeados del disco
+    MappedFile file;
+    if (!AssetPack::getInstance().find(source, data, size)) {
+        if (!file.open(string(source.path()))){return false;}
+        data = file.data();
+        size = file.size();
+    }
+    uint64_t hash = RawImageCache::contentHash(data, size);
+    auto raw = make_unique<RawImage>();
+    if (rawCache.load(source, shift, hash, *raw)) {
+        out.scale *= raw->scale;
+        out.raw = move(raw);
+        return true;
+    }
+    out.image = make_unique<Image>();
+    if (!out.image->loadFromMemory(data, size)) {
+        out.image.reset();
+        return false;
+    }
+    //Sin variante: se reduce aca (en el worker si es async)
+    unsigned reduced = 1;
+    for (unsigned i = 0; i < shift && halveImage(*out.image); ++i) {
+        reduced *= 2;
+    }
+    out.scale *= float(reduced);
+    //La proxima vez se mapea el resultado en vez de decodificar
+    rawCache.store(source, shift, hash, *out.image, reduced);
+    return true;
+}
+
+void ResourceManager::enqueueDecode(ResourceId id, bool sound) {
+    {
+        lock_guard<mutex> lock(preloadMutex);
+        requestedIds.insert(id);
+        decodeJobs.push_back(DecodeJob{ id, sound });
+    }
+    jobReady.notify_one();
+}
+
+void ResourceManager::decodeLoop() {
+    while (true) {
+        DecodeJob job;
+        {
+            unique_lock<mutex> lock(preloadMutex);
+            jobReady.wait(lock, [this] { return stopping || !decodeJobs.empty(); });
+            if (stopping){return;}
+            job = decodeJobs.front();
+            decodeJobs.pop_front();
+        }
+        bool ok = job.sound ? preloadSound(job.id) : preloadImage(job.id);
+        if (!ok) {
+            lock_guard<mutex> lock(preloadMutex);
+            failedIds.insert(job.id);
+        }
+    }
+}
+
+bool ResourceManager::takePreloadedImage(ResourceId id, DecodedImage& image, bool& failed) {
+    lock_guard<mutex> lock(preloadMutex);
+    auto pre = preloadedImages.find(id);
+    if (pre != preloadedImages.end()) {
+        image = move(pre->second);
+        preloadedImages.erase(pre);
+        return true;
+    }
+    failed = failedIds.erase(id) > 0;
+    return false;
+}
+
+bool ResourceManager::takePreloadedSound(ResourceId id, unique_ptr<SoundBuffer>& buffer, bool& failed) {
+    lock_guard<mutex> lock(preloadMutex);
+    auto pre = preloadedSounds.find(id);
+    if (pre != preloadedSounds.end()) {
+        buffer = move(pre->second);
+        preloadedSounds.erase(pre);
+        return true;
+    }
+    failed = failedIds.erase(id) > 0;
+    return false;
+}
+
+void ResourceManager::finishRequest(ResourceId id) {
+    lock_guard<mutex> lock(preloadMutex);
+    requestedIds.erase(id);
+}
+
+bool ResourceManager::preloadImage(ResourceId id) {
+    if (isResident(id)){return true;}
+    {
+        lock_guard<mutex> lock(preloadMutex);
+        if (preloadedImages.count(id)){return true;}
+    }
+    DecodedImage image;
+    if (!decodeImage(id, image)) {
+        cout << "ERROR: No se pudo precargar imagen: " << id.path() << endl;
+        return false;
+    }
+    lock_guard<mutex> lock(preloadMutex);
+    if (!residentIds.count(id)) {
+        preloadedImages.emplace(id, move(image));
+    }
+    return true;
+}
+
+bool ResourceManager::preloadSound(ResourceId id) {
+    if (isResident(id)){return true;}
+    {
+        lock_guard<mutex> lock(preloadMutex);
+        if (preloadedSounds.count(id)){return true;}
+    }
+    auto buffer = make_unique<SoundBuffer>();
+    if (!loadAsset(*buffer, id)) {
+        cout << "ERROR: No se pudo precargar sonido: " << id.path() << endl;
+        return false;
+    }
+    lock_guard<mutex> lock(preloadMutex);
+    if (!residentIds.count(id)) {
+        preloadedSounds.emplace(id, move(buffer));
+    }
+    return true;
+}
+
+bool ResourceManager::isResident(ResourceId id) {
+    lock_guard<mutex> lock(preloadMutex);
+    return residentIds.count(id) > 0;
+}
+
+void ResourceManager::discardPreloaded(const set<ResourceId>& keep) {
+    lock_guard<mutex> lock(preloadMutex);
+    auto kept = [&](ResourceId id) {
+        return keep.count(id) > 0 || requestedIds.count(id) > 0;
+    };
+    for (auto it = preloadedImages.begin(); it != preloadedImages.end();) {
+        it = kept(it->first) ? next(it) : preloadedImages.erase(it);
+    }
+    for (auto it = preloadedSounds.begin(); it != preloadedSounds.end();) {
+        it = kept(it->first) ? next(it) : preloadedSounds.erase(it);
+    }
+}
+
+void ResourceManager::markResident(ResourceId id) {
+    lock_guard<mutex> lock(preloadMutex);
+    residentIds.insert(id);
+}
+
+void ResourceManager::forgetResident(ResourceId id) {
+    lock_guard<mutex> lock(preloadMutex);
+    residentIds.erase(id);
 }
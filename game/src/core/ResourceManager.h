@@ -3,22 +3,252 @@
 
 #include <iostream>
 #include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
+#include "ResourceId.h"
+#include "RawImageCache.h"
+#include "../graphics/TextureAtlas.h"
+#include "../graphics/GlyphAtlas.h"
 using namespace std;
 using namespace sf;
 
+enum class ResourceState : uint8_t {
+    Loading,
+    Ready,
+    Failed
+};
+
+//Contabilidad comun para el LRU (solo hilo principal)
+struct ResourceEntry {
+    ResourceId id;
+    ResourceState state = ResourceState::Loading;
+    int refs = 0;
+    //Pedido con getTexture/getSound: alguien guarda la referencia, nunca se libera
+    //(acquireTexture/acquireSound cargan igual de sincronico pero con handle)
+    bool pinned = false;
+    size_t bytes = 0;
+    uint64_t lastUse = 0;
+    void acquire();
+    void release();
+};
+
+struct TextureEntry : ResourceEntry {
+    Texture texture;
+    //Pixeles de la imagen original por pixel de textura (2 = variante a la mitad)
+    float scale = 1.f;
+};
+
+//Resolucion a la que se cargan las imagenes grandes (fondos): la original, 1/2 o 1/4
+enum class TextureTier : uint8_t {
+    Full,
+    Half,
+    Quarter
+};
+
+struct SoundEntry : ResourceEntry {
+    unique_ptr<SoundBuffer> buffer;
+};
+
+//Referencia contada: mientras haya un handle vivo el recurso no se libera
+template <typename Entry>
+class ResourceHandle {
+public:
+    ResourceHandle() : entry(nullptr) {}
+    ResourceHandle(const ResourceHandle& other) : entry(other.entry) {
+        if (entry){entry->acquire();}
+    }
+    ResourceHandle(ResourceHandle&& other) noexcept : entry(other.entry) {
+        other.entry = nullptr;
+    }
+    ResourceHandle& operator=(ResourceHandle other) {
+        swap(entry, other.entry);
+        return *this;
+    }
+    ~ResourceHandle() {
+        if (entry){entry->release();}
+    }
+    bool valid() const { return entry != nullptr; }
+    bool ready() const { return entry && entry->state == ResourceState::Ready; }
+    bool failed() const { return entry && entry->state == ResourceState::Failed; }
+    ResourceId id() const { return entry ? entry->id : ResourceId(); }
+protected:
+    explicit ResourceHandle(Entry* e) : entry(e) {
+        if (entry){entry->acquire();}
+    }
+    Entry* entry;
+};
+
+//Textura pedida con loadTextureAsync/acquireTexture: mientras carga get() da una textura vacia (no dibuja nada)
+class TextureHandle : public ResourceHandle<TextureEntry> {
+public:
+    TextureHandle() {}
+    const Texture& get() const;
+    //Escala para el sprite: con ella ocupa lo mismo que la original en la vista 1920x1080
+    float scale() const { return ready() ? entry->scale : 1.f; }
+private:
+    friend class ResourceManager;
+    explicit TextureHandle(TextureEntry* e) : ResourceHandle(e) {}
+};
+
+//Sonido pedido con loadSoundAsync/acquireSound: get() es nullptr hasta que este decodificado
+class SoundHandle : public ResourceHandle<SoundEntry> {
+public:
+    SoundHandle() {}
+    const SoundBuffer* get() const { return ready() ? entry->buffer.get() : nullptr; }
+private:
+    friend class ResourceManager;
+    explicit SoundHandle(SoundEntry* e) : ResourceHandle(e) {}
+};
+
 class ResourceManager {
 private:
-    map<string, Texture> textures;
-    map<string, Font> fonts;
-    map<string, SoundBuffer> sounds;
+    //Indexados por el hash ya calculado: un acceso, sin comparar strings
+    //(unordered_map no mueve los elementos, los handles apuntan a ellos)
+    unordered_map<ResourceId, TextureEntry, ResourceIdHash> textures;
+    unordered_map<ResourceId, Font, ResourceIdHash> fonts;
+    unordered_map<ResourceId, uint64_t, ResourceIdHash> fontHashes;
+    unordered_map<ResourceId, SoundEntry, ResourceIdHash> sounds;
+    //Personajes y widgets de UI empaquetados al iniciar
+    TextureAtlas atlas;
+    //Glifos de las fuentes de dialogo ya rasterizados (una textura por fuente)
+    unordered_map<ResourceId, unique_ptr<GlyphAtlas>, ResourceIdHash> glyphAtlases;
+    //Precarga desde otro hilo: solo decodifica, la subida a GPU la hace el hilo principal
+    mutex preloadMutex;
+    //Decodificada del png (image) o mapeada de la cache de blobs (raw)
+    struct DecodedImage {
+        unique_ptr<Image> image;
+        unique_ptr<RawImage> raw;
+        float scale = 1.f;
+    };
+    unordered_map<ResourceId, DecodedImage, ResourceIdHash> preloadedImages;
+    unordered_map<ResourceId, unique_ptr<SoundBuffer>, ResourceIdHash> preloadedSounds;
+    unordered_set<ResourceId, ResourceIdHash> residentIds;
+    void markResident(ResourceId id);
+    void forgetResident(ResourceId id);
+    //Pool de decodificacion para los pedidos async
+    struct DecodeJob {
+        ResourceId id;
+        bool sound;
+    };
+    vector<thread> decodeWorkers;
+    condition_variable jobReady;
+    deque<DecodeJob> decodeJobs;
+    unordered_set<ResourceId, ResourceIdHash> requestedIds;
+    unordered_set<ResourceId, ResourceIdHash> failedIds;
+    bool stopping;
+    //Pedidos async que esperan su subida (solo hilo principal)
+    vector<ResourceId> pendingTextures;
+    vector<ResourceId> pendingSounds;
+    Time uploadBudget;
+    void decodeLoop();
+    void enqueueDecode(ResourceId id, bool sound);
+    bool takePreloadedImage(ResourceId id, DecodedImage& image, bool& failed);
+    //Desde cualquier hilo: variante del tier actual (offline o reducida al cargar)
+    bool decodeImage(ResourceId id, DecodedImage& out);
+    atomic<TextureTier> textureTier;
+    vector<string> tieredPaths;
+    unsigned textureGeneration;
+    unsigned tierShift(ResourceId id) const;
+    bool isTiered(ResourceId id) const;
+    //Al cambiar de tier: libera o recarga en el lugar lo que ya estaba cargado
+    void retierTextures();
+    RawImageCache rawCache;
+    bool takePreloadedSound(ResourceId id, unique_ptr<SoundBuffer>& buffer, bool& failed);
+    void finishRequest(ResourceId id);
+    void loadTextureNow(TextureEntry& entry);
+    void loadSoundNow(SoundEntry& entry);
+    void finishTexture(TextureEntry& entry, const DecodedImage& image);
+    bool uploadTexture(TextureEntry& entry, const DecodedImage& image);
+    void finishSound(SoundEntry& entry, unique_ptr<SoundBuffer> buffer);
+    void uploadPending();
+    //Tope de memoria por tipo: se liberan los que no tienen handles, el menos usado primero
+    size_t textureBudget;
+    size_t soundBudget;
+    size_t textureBytes;
+    size_t soundBytes;
+    //Atlas y atlas de glifos: viven todo el juego, fuera de lo que maneja el LRU
+    size_t atlasBytes;
+    //Reloj del LRU en la ultima pasada que no pudo liberar nada: no se repite hasta que algo cambie
+    uint64_t textureScanClock;
+    uint64_t soundScanClock;
+    template <typename Entries>
+    void evictUnused(Entries& entries, size_t& used, size_t budget, uint64_t& scanClock, const char* kind);
 
 public:
-    ResourceManager() {}
-    Texture& getTexture(const string& path);
-    Font& getFont(const string& path);
-    SoundBuffer& getSound(const string& path);
+    ResourceManager();
+    ~ResourceManager();
+    ResourceManager(const ResourceManager&) = delete;
+    ResourceManager& operator=(const ResourceManager&) = delete;
+    //Sincronicos: si el recurso no esta listo lo cargan en el momento
+    //La referencia queda fija (nunca se libera): para lo que se usa todo el juego
+    Texture& getTexture(ResourceId id);
+    Font& getFont(ResourceId id);
+    SoundBuffer& getSound(ResourceId id);
+    //Sincronicos con handle: ya listos al volver, el LRU los libera cuando se suelta el ultimo
+    TextureHandle acquireTexture(ResourceId id);
+    SoundHandle acquireSound(ResourceId id);
+    //Async: decodifican en el pool y quedan listos en algun update()
+    TextureHandle loadTextureAsync(ResourceId id);
+    SoundHandle loadSoundAsync(ResourceId id);
+    //Con ruta: calculan el id en cada llamada, para usos de una sola vez
+    Texture& getTexture(const string& path) { return getTexture(ResourceId::of(path)); }
+    Font& getFont(const string& path) { return getFont(ResourceId::of(path)); }
+    SoundBuffer& getSound(const string& path) { return getSound(ResourceId::of(path)); }
+    //Empaqueta estas imagenes en paginas compartidas (una vez, al iniciar)
+    bool buildAtlas(const vector<ResourceId>& ids);
+    //Region en el atlas; si no esta empaquetada, la textura suelta entera (sincronico)
+    AtlasRegion getRegion(ResourceId id);
+    //Solo el atlas: region vacia si no esta empaquetada
+    AtlasRegion findRegion(ResourceId id) const;
+    //Rasteriza (o lee de cachePath) los glifos de la fuente a esos tamaños; llamar al iniciar
+    //extra: codepoints fuera del charset base que usa el juego
+    bool buildGlyphAtlas(ResourceId fontId, const vector<unsigned>& sizes, const vector<Uint32>& extra, const string& cachePath);
+    //Hash del contenido del ttf (0 si no se puede leer); se calcula una vez por fuente
+    uint64_t getFontHash(ResourceId fontId);
+    //nullptr si no se armo atlas para esa fuente
+    const GlyphAtlas* findGlyphAtlas(ResourceId fontId) const;
+    //Una vez por frame en el hilo principal: sube a GPU lo ya decodificado (con tope de tiempo)
+    //y libera lo que no se usa si se paso del presupuesto
+    void update();
+    void setUploadBudget(Time budget);
+    //Bytes reales: ancho*alto*4 para texturas, muestras*2 para sonidos
+    //El presupuesto de texturas no cuenta los atlas (no se pueden liberar)
+    void setTextureBudget(size_t bytes);
+    void setSoundBudget(size_t bytes);
+    size_t getTextureBytes() const;
+    size_t getAtlasBytes() const;
+    //Rutas (prefijos) con variantes por tier; llamar al iniciar, antes de pedir texturas
+    void setTieredPaths(const vector<string>& prefixes);
+    //Las texturas con variantes sin handles se liberan; las que estan en uso se recargan
+    //en el mismo Texture (cambia el tamaño: ver getTextureGeneration)
+    void setTextureTier(TextureTier tier);
+    TextureTier getTextureTier() const;
+    //Sube cada vez que setTextureTier recarga texturas: quien las usa rearma rect y escala del sprite
+    unsigned getTextureGeneration() const;
+    //Carpeta para los pngs ya decodificados (vacia = siempre decodificar); llamar al iniciar
+    bool setRawCacheDirectory(const string& dir);
+    //Tier segun el tamaño real de la ventana; memorySaver baja uno mas
+    static TextureTier tierFor(Vector2u windowSize, bool memorySaver);
+    //Escala de una textura ya cargada (1 si no esta o es la original)
+    float getTextureScale(ResourceId id) const;
+    size_t getSoundBytes() const;
+    //Seguros desde cualquier hilo
+    bool preloadImage(ResourceId id);
+    bool preloadSound(ResourceId id);
+    bool isResident(ResourceId id);
+    //Descarta lo precargado que nunca se uso (menos lo de keep y lo pedido async)
+    void discardPreloaded(const set<ResourceId>& keep = set<ResourceId>());
 };
 
 #endif
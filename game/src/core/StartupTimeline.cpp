@@ -0,0 +1,26 @@
+#include "StartupTimeline.h"
+#include <iostream>
+
+StartupTimeline& StartupTimeline::getInstance() {
+    static StartupTimeline instance;
+    return instance;
+}
+
+void StartupTimeline::mark(const string& stage) {
+    float ms = clock.getElapsedTime().asMicroseconds() / 1000.f;
+    float previous = stages.empty() ? 0.f : stages.back().ms;
+    stages.push_back(Stage{ stage, ms });
+    cout << "[Startup] " << stage << ": " << ms << " ms (+" << ms - previous << ")" << endl;
+}
+
+float StartupTimeline::msUntil(const string& stage) const {
+    for (const auto& s : stages) {
+        if (s.name == stage){return s.ms;}
+    }
+    return -1.f;
+}
+
+void StartupTimeline::report() const {
+    cout << "[Startup] Primer frame: " << msUntil("primer frame") << " ms, menu interactivo: "
+         << msUntil("menu interactivo") << " ms" << endl;
+}
@@ -0,0 +1,31 @@
+#ifndef STARTUP_TIMELINE_H
+#define STARTUP_TIMELINE_H
+
+#include <SFML/System.hpp>
+#include <string>
+#include <vector>
+using namespace std;
+using namespace sf;
+
+//Marcas de tiempo del arranque (solo hilo principal)
+//El reloj empieza con el primer getInstance(): llamarlo al principio de main
+class StartupTimeline {
+public:
+    static StartupTimeline& getInstance();
+    //Guarda y loguea los ms desde el inicio hasta esta etapa
+    void mark(const string& stage);
+    //Ms hasta la etapa; -1 si todavia no se marco
+    float msUntil(const string& stage) const;
+    //Resumen: primer frame y menu interactivo
+    void report() const;
+private:
+    StartupTimeline() = default;
+    struct Stage {
+        string name;
+        float ms;
+    };
+    Clock clock;
+    vector<Stage> stages;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#include "StringPool.h"
+
+NameTable::NameTable()
+: arena(4 * 1024)
+{
+}
+
+NameTable& NameTable::getInstance() {
+    static NameTable instance;
+    return instance;
+}
+
+string_view NameTable::intern(string_view s) {
+    if (s.empty()){return string_view();}
+    lock_guard<mutex> lock(tableMutex);
+    auto it = names.find(s);
+    if (it != names.end()){return *it;}
+    string_view stored = arena.copy(s);
+    names.insert(stored);
+    return stored;
+}
+
+size_t NameTable::size() const {
+    lock_guard<mutex> lock(tableMutex);
+    return names.size();
+}
+
+StringPool::StringPool(Arena* a)
+: arena(a),
+  strings(a),
+  ids(a)
+{
+}
+
+StrId StringPool::intern(string_view s) {
+    if (s.empty()){return 0;}
+    auto it = ids.find(s);
+    if (it != ids.end()){return it->second;}
+    return add(arena->copy(s));
+}
+
+StrId StringPool::internName(string_view s) {
+    if (s.empty()){return 0;}
+    auto it = ids.find(s);
+    if (it != ids.end()){return it->second;}
+    return add(NameTable::getInstance().intern(s));
+}
+
+StrId StringPool::add(string_view stored) {
+    //El id 0 es "" y no ocupa lugar en el vector
+    strings.push_back(stored);
+    StrId id = static_cast<StrId>(strings.size());
+    ids.emplace(stored, id);
+    return id;
+}
+
+string_view StringPool::get(StrId id) const {
+    if (id == 0 || id > strings.size()){return string_view();}
+    return strings[id - 1];
+}
+
+size_t StringPool::size() const {
+    return strings.size() + 1;
+}
+
+void StringPool::clear() {
+    pmr::vector<string_view>(arena).swap(strings);
+    pmr::unordered_map<string_view, StrId>(arena).swap(ids);
+}
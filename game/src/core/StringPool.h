@@ -0,0 +1,53 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory_resource>
+#include <mutex>
+#include <cstdint>
+#include "Arena.h"
+using namespace std;
+
+//Id de un string internado, el 0 siempre es ""
+typedef uint32_t StrId;
+
+//Nombres que se repiten entre escenas (speakers, rutas, flags): una sola copia para todo el juego
+//Nunca se liberan; son pocos y los usan todas las escenas. Se puede usar desde varios hilos
+class NameTable {
+public:
+    static NameTable& getInstance();
+    string_view intern(string_view s);
+    size_t size() const;
+private:
+    NameTable();
+    mutable mutex tableMutex;
+    Arena arena;
+    unordered_set<string_view> names;
+};
+
+//Guarda cada string una sola vez y lo referencia por id
+//Las vistas y el indice viven en el arena recibido (el de la escena)
+class StringPool {
+public:
+    explicit StringPool(Arena* arena);
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+    //Copia el texto al arena (dialogos, textos de choices)
+    StrId intern(string_view s);
+    //El texto queda en la NameTable compartida, solo el id es de esta escena
+    StrId internName(string_view s);
+    string_view get(StrId id) const;
+    size_t size() const;
+    //No libera el texto: eso lo hace el reset del arena
+    void clear();
+private:
+    Arena* arena;
+    pmr::vector<string_view> strings;
+    pmr::unordered_map<string_view, StrId> ids;
+    StrId add(string_view stored);
+};
+
+#endif
@@ -0,0 +1,261 @@
+#include "GlyphAtlas.h"
+#include "../core/MappedFile.h"
+#include "../core/AtomicFile.h"
+#include "../core/Fnv.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+static const char GlyphMagic[4] = { 'R', 'G', 'L', 'Y' };
+//Ancho fijo; el alto es lo que ocupen los estantes
+static const unsigned AtlasWidth = 1024;
+static const unsigned AtlasPadding = 2;
+
+GlyphAtlas::GlyphAtlas()
+: font(nullptr),
+  ready(false)
+{
+}
+
+vector<Uint32> GlyphAtlas::defaultCharset() {
+    vector<Uint32> chars;
+    for (Uint32 c = 0x20; c < 0x7F; ++c) {
+        chars.push_back(c);
+    }
+    for (Uint32 c = 0xA0; c <= 0xFF; ++c) {
+        chars.push_back(c);
+    }
+    //Rayas, comillas curvas y puntos suspensivos
+    const Uint32 extra[] = { 0x2013, 0x2014, 0x2018, 0x2019, 0x201C, 0x201D, 0x2026 };
+    chars.insert(chars.end(), begin(extra), end(extra));
+    return chars;
+}
+
+uint64_t GlyphAtlas::key(Uint32 codepoint, unsigned size) {
+    return (uint64_t(size) << 32) | codepoint;
+}
+
+uint64_t GlyphAtlas::requestHash() const {
+    uint64_t h = FnvOffset;
+    for (unsigned s : sizes) {
+        h = fnv1aMix(h, s);
+    }
+    h = fnv1aMix(h, 0xFFFFFFFFull);
+    for (Uint32 c : charset) {
+        h = fnv1aMix(h, c);
+    }
+    return h;
+}
+
+bool GlyphAtlas::build(const Font& f, uint64_t fontHash, const vector<unsigned>& requested, const vector<Uint32>& extra, const string& cachePath) {
+    font = &f;
+    ready = false;
+    sizes = requested;
+    sort(sizes.begin(), sizes.end());
+    sizes.erase(unique(sizes.begin(), sizes.end()), sizes.end());
+    charset = defaultCharset();
+    charset.insert(charset.end(), extra.begin(), extra.end());
+    sort(charset.begin(), charset.end());
+    charset.erase(unique(charset.begin(), charset.end()), charset.end());
+    glyphs.clear();
+    lineSpacings.clear();
+    if (!cachePath.empty() && loadCache(cachePath, fontHash)) {
+        ready = true;
+        return true;
+    }
+    Image pixels;
+    if (!rasterize(pixels)) {
+        cerr << "[Resources] ERROR: no se pudo armar el atlas de glifos" << endl;
+        glyphs.clear();
+        return false;
+    }
+    if (!texture.loadFromImage(pixels)) {
+        glyphs.clear();
+        return false;
+    }
+    texture.setSmooth(true);
+    if (!cachePath.empty()) {
+        storeCache(cachePath, fontHash, pixels);
+    }
+    ready = true;
+    return true;
+}
+
+bool GlyphAtlas::rasterize(Image& pixels) {
+    struct Item {
+        unsigned size;
+        Uint32 codepoint;
+        Glyph glyph;
+    };
+    vector<Item> items;
+    items.reserve(sizes.size() * charset.size());
+    map<unsigned, Image> sources;
+    for (unsigned size : sizes) {
+        for (Uint32 c : charset) {
+            items.push_back(Item{ size, c, font->getGlyph(c, size, false) });
+        }
+        lineSpacings[size] = font->getLineSpacing(size);
+        //Despues de pedir todos: la pagina de la Font ya tiene los glifos de este tamaño
+        sources[size] = font->getTexture(size).copyToImage();
+    }
+    //Estantes: los mas altos primero, filas de izquierda a derecha
+    sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+        return a.glyph.textureRect.height > b.glyph.textureRect.height;
+    });
+    unsigned x = AtlasPadding;
+    unsigned y = AtlasPadding;
+    unsigned rowHeight = 0;
+    vector<Vector2u> placed(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        const IntRect& r = items[i].glyph.textureRect;
+        if (x + r.width + AtlasPadding > AtlasWidth) {
+            x = AtlasPadding;
+            y += rowHeight + AtlasPadding;
+            rowHeight = 0;
+        }
+        placed[i] = Vector2u(x, y);
+        x += r.width + AtlasPadding;
+        rowHeight = max(rowHeight, unsigned(r.height));
+    }
+    unsigned height = y + rowHeight + AtlasPadding;
+    if (height > Texture::getMaximumSize()){return false;}
+    //Blanco transparente como las paginas de Font: el color lo ponen los vertices
+    pixels.create(AtlasWidth, height, Color(255, 255, 255, 0));
+    for (size_t i = 0; i < items.size(); ++i) {
+        Glyph glyph = items[i].glyph;
+        if (glyph.textureRect.width > 0 && glyph.textureRect.height > 0) {
+            pixels.copy(sources[items[i].size], placed[i].x, placed[i].y, glyph.textureRect);
+        }
+        glyph.textureRect.left = int(placed[i].x);
+        glyph.textureRect.top = int(placed[i].y);
+        glyphs[key(items[i].codepoint, items[i].size)] = glyph;
+    }
+    cout << "[Resources] Atlas de glifos: " << glyphs.size() << " glifos en " << AtlasWidth << "x" << height << endl;
+    return true;
+}
+
+bool GlyphAtlas::loadCache(const string& path, uint64_t fontHash) {
+    MappedFile file;
+    if (!file.open(path)){return false;}
+    GlyphCacheHeader h;
+    if (file.size() < sizeof(h)){return false;}
+    memcpy(&h, file.data(), sizeof(h));
+    uint64_t expected = sizeof(h) + uint64_t(h.sizeCount) * sizeof(GlyphCacheSize)
+                      + uint64_t(h.glyphCount) * sizeof(GlyphCacheRecord) + uint64_t(h.width) * h.height;
+    if (memcmp(h.magic, GlyphMagic, 4) != 0 || h.version != Version || h.fontHash != fontHash
+        || h.requestHash != requestHash() || file.size() != expected || h.width == 0 || h.height == 0) {
+        return false;
+    }
+    const char* p = file.data() + sizeof(h);
+    for (uint32_t i = 0; i < h.sizeCount; ++i) {
+        GlyphCacheSize s;
+        memcpy(&s, p, sizeof(s));
+        p += sizeof(s);
+        lineSpacings[s.size] = s.lineSpacing;
+    }
+    glyphs.reserve(h.glyphCount);
+    for (uint32_t i = 0; i < h.glyphCount; ++i) {
+        GlyphCacheRecord r;
+        memcpy(&r, p, sizeof(r));
+        p += sizeof(r);
+        Glyph g;
+        g.advance = r.advance;
+        g.bounds = FloatRect(r.bounds[0], r.bounds[1], r.bounds[2], r.bounds[3]);
+        g.textureRect = IntRect(r.rect[0], r.rect[1], r.rect[2], r.rect[3]);
+        glyphs[key(r.codepoint, r.size)] = g;
+    }
+    //Solo se guarda el alpha: se expande a blanco + alpha para la textura
+    vector<Uint8> rgba(size_t(h.width) * h.height * 4, 255);
+    const Uint8* alpha = reinterpret_cast<const Uint8*>(p);
+    for (size_t i = 0; i < size_t(h.width) * h.height; ++i) {
+        rgba[i * 4 + 3] = alpha[i];
+    }
+    if (!texture.create(h.width, h.height)) {
+        glyphs.clear();
+        lineSpacings.clear();
+        return false;
+    }
+    texture.update(rgba.data());
+    texture.setSmooth(true);
+    return true;
+}
+
+bool GlyphAtlas::storeCache(const string& path, uint64_t fontHash, const Image& pixels) const {
+    GlyphCacheHeader h;
+    memcpy(h.magic, GlyphMagic, 4);
+    h.version = Version;
+    h.fontHash = fontHash;
+    h.requestHash = requestHash();
+    h.width = pixels.getSize().x;
+    h.height = pixels.getSize().y;
+    h.sizeCount = uint32_t(lineSpacings.size());
+    h.glyphCount = uint32_t(glyphs.size());
+    //Renombrar al final: nadie lee un atlas a medio escribir
+    return writeFileAtomic(path, [&](ofstream& f) {
+        f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        for (const auto& s : lineSpacings) {
+            GlyphCacheSize rec{ s.first, s.second };
+            f.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+        }
+        for (const auto& g : glyphs) {
+            GlyphCacheRecord rec;
+            rec.size = uint32_t(g.first >> 32);
+            rec.codepoint = uint32_t(g.first & 0xFFFFFFFFu);
+            rec.advance = g.second.advance;
+            rec.bounds[0] = g.second.bounds.left;
+            rec.bounds[1] = g.second.bounds.top;
+            rec.bounds[2] = g.second.bounds.width;
+            rec.bounds[3] = g.second.bounds.height;
+            rec.rect[0] = g.second.textureRect.left;
+            rec.rect[1] = g.second.textureRect.top;
+            rec.rect[2] = g.second.textureRect.width;
+            rec.rect[3] = g.second.textureRect.height;
+            f.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+        }
+        size_t count = size_t(h.width) * h.height;
+        vector<char> alpha(count);
+        const Uint8* px = pixels.getPixelsPtr();
+        for (size_t i = 0; i < count; ++i) {
+            alpha[i] = char(px[i * 4 + 3]);
+        }
+        f.write(alpha.data(), streamsize(count));
+    });
+}
+
+bool GlyphAtlas::isReady() const {
+    return ready;
+}
+
+const Texture& GlyphAtlas::getTexture() const {
+    return texture;
+}
+
+const Glyph* GlyphAtlas::find(Uint32 codepoint, unsigned size) const {
+    auto it = glyphs.find(key(codepoint, size));
+    return it == glyphs.end() ? nullptr : &it->second;
+}
+
+bool GlyphAtlas::hasSize(unsigned size) const {
+    return lineSpacings.count(size) > 0;
+}
+
+float GlyphAtlas::lineSpacing(unsigned size) const {
+    auto it = lineSpacings.find(size);
+    return it == lineSpacings.end() ? float(size) : it->second;
+}
+
+float GlyphAtlas::kerning(Uint32 first, Uint32 second, unsigned size) const {
+    return font ? font->getKerning(first, second, size) : 0.f;
+}
+
+size_t GlyphAtlas::glyphCount() const {
+    return glyphs.size();
+}
+
+const vector<Uint32>& GlyphAtlas::codepoints() const {
+    return charset;
+}
+
+const vector<unsigned>& GlyphAtlas::characterSizes() const {
+    return sizes;
+}
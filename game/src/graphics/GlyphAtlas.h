@@ -0,0 +1,79 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+using namespace std;
+using namespace sf;
+
+//Archivo .glyphs: cabecera + tamaños + glifos + alpha de la textura (1 byte por pixel)
+#pragma pack(push, 1)
+struct GlyphCacheHeader {
+    char magic[4];
+    uint32_t version;
+    //Hash del .ttf y de lo pedido (tamaños + charset): si cambia algo se vuelve a rasterizar
+    uint64_t fontHash;
+    uint64_t requestHash;
+    uint32_t width;
+    uint32_t height;
+    uint32_t sizeCount;
+    uint32_t glyphCount;
+};
+struct GlyphCacheSize {
+    uint32_t size;
+    float lineSpacing;
+};
+struct GlyphCacheRecord {
+    uint32_t size;
+    uint32_t codepoint;
+    float advance;
+    float bounds[4];
+    int32_t rect[4];
+};
+#pragma pack(pop)
+
+//Glifos de una fuente ya rasterizados en una sola textura, para varios tamaños
+//Todo el texto que la usa se dibuja en un solo draw call (mismo Texture para todos los tamaños)
+class GlyphAtlas {
+public:
+    static const uint32_t Version = 1;
+    GlyphAtlas();
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+    //Lee el atlas de cachePath si es de esta fuente y pedido; si no, rasteriza y lo guarda ahi
+    //extra se suma al charset (lo que usa la historia). cachePath vacio = siempre rasterizar
+    //La Font tiene que vivir mas que el atlas (kerning)
+    bool build(const Font& font, uint64_t fontHash, const vector<unsigned>& sizes, const vector<Uint32>& extra, const string& cachePath);
+    bool isReady() const;
+    const Texture& getTexture() const;
+    //nullptr si ese codepoint no se rasterizo a ese tamaño
+    const Glyph* find(Uint32 codepoint, unsigned size) const;
+    bool hasSize(unsigned size) const;
+    float lineSpacing(unsigned size) const;
+    float kerning(Uint32 first, Uint32 second, unsigned size) const;
+    size_t glyphCount() const;
+    //Charset con el que se armo (ordenado) y tamaños
+    const vector<Uint32>& codepoints() const;
+    const vector<unsigned>& characterSizes() const;
+    //ASCII imprimible, Latin-1 (á, ñ, ¿, ¡...) y la puntuacion tipografica de los dialogos
+    static vector<Uint32> defaultCharset();
+private:
+    const Font* font;
+    Texture texture;
+    bool ready;
+    vector<unsigned> sizes;
+    vector<Uint32> charset;
+    map<unsigned, float> lineSpacings;
+    unordered_map<uint64_t, Glyph> glyphs;
+    static uint64_t key(Uint32 codepoint, unsigned size);
+    uint64_t requestHash() const;
+    bool rasterize(Image& pixels);
+    bool loadCache(const string& path, uint64_t fontHash);
+    bool storeCache(const string& path, uint64_t fontHash, const Image& pixels) const;
+};
+
+#endif
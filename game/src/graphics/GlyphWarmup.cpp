@@ -0,0 +1,79 @@
+#include "GlyphWarmup.h"
+#include "TextLayout.h"
+#include <iostream>
+
+GlyphWarmup& GlyphWarmup::getInstance() {
+    static GlyphWarmup instance;
+    return instance;
+}
+
+GlyphWarmup::GlyphWarmup()
+: warmed(0),
+  missCount(0)
+{
+}
+
+void GlyphWarmup::collect(const string& utf8, set<Uint32>& out) {
+    for (size_t i = 0; i < utf8.size();) {
+        Uint32 cp = TextLayout::decodeUtf8(utf8, i);
+        if (cp > ' '){out.insert(cp);}
+    }
+}
+
+size_t GlyphWarmup::warm(const Font& font, const set<Uint32>& codepoints, const vector<unsigned>& sizes) {
+    size_t count = 0;
+    set<uint64_t>& loaded = fontGlyphs[&font];
+    for (unsigned size : sizes) {
+        //El espacio no se dibuja pero Text pide su avance
+        font.getGlyph(' ', size, false);
+        for (Uint32 cp : codepoints) {
+            font.getGlyph(cp, size, false);
+            loaded.insert((uint64_t(size) << 32) | cp);
+            count++;
+        }
+    }
+    warmed += count;
+    return count;
+}
+
+void GlyphWarmup::addWarmed(size_t glyphs) {
+    warmed += glyphs;
+}
+
+void GlyphWarmup::countMiss(Uint32 codepoint, unsigned size) {
+    missCount++;
+    if (missed.insert((uint64_t(size) << 32) | codepoint).second) {
+        cout << "[Glyphs] Glifo sin precalentar: U+" << hex << uppercase << codepoint << dec << nouppercase
+             << " a " << size << "px" << endl;
+    }
+}
+
+void GlyphWarmup::checkGlyph(const Font& font, Uint32 codepoint, unsigned size) {
+    if (codepoint <= ' '){return;}
+    //Despues del primer draw ya esta en la pagina de la Font: se cuenta una sola vez
+    if (fontGlyphs[&font].insert((uint64_t(size) << 32) | codepoint).second) {
+        countMiss(codepoint, size);
+    }
+}
+
+void GlyphWarmup::checkText(const Text& text) {
+    const Font* font = text.getFont();
+    if (!font){return;}
+    const String& str = text.getString();
+    for (size_t i = 0; i < str.getSize(); ++i) {
+        checkGlyph(*font, str[i], text.getCharacterSize());
+    }
+}
+
+size_t GlyphWarmup::warmedGlyphs() const {
+    return warmed;
+}
+
+size_t GlyphWarmup::misses() const {
+    return missCount;
+}
+
+void GlyphWarmup::report() const {
+    cout << "[Glyphs] Precalentados: " << warmed << " glifos, faltaron en juego: " << missCount
+         << " (" << missed.size() << " distintos)" << endl;
+}
@@ -0,0 +1,43 @@
+#ifndef GLYPH_WARMUP_H
+#define GLYPH_WARMUP_H
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <cstdint>
+using namespace std;
+using namespace sf;
+
+//Glifos que usa el juego, rasterizados durante la carga (solo hilo principal)
+//sf::Font rasteriza cada codepoint la primera vez que se dibuja: sin esto una "ñ" nueva
+//se sube a la GPU en medio del typewriter. Cuenta lo precalentado y lo que igual falto
+class GlyphWarmup {
+public:
+    static GlyphWarmup& getInstance();
+    //Agrega a out los codepoints del texto utf8 (sin espacios ni saltos)
+    static void collect(const string& utf8, set<Uint32>& out);
+    //Pide a la Font cada codepoint en cada tamaño; devuelve cuantos glifos se pidieron
+    size_t warm(const Font& font, const set<Uint32>& codepoints, const vector<unsigned>& sizes);
+    //Glifos que se armaron por otro lado (atlas de glifos)
+    void addWarmed(size_t glyphs);
+    //Un glifo que hubo que rasterizar en medio del juego; se loguea la primera vez
+    void countMiss(Uint32 codepoint, unsigned size);
+    //Para lo que se dibuja con la Font (Text, corridas sin atlas): cuenta como faltante
+    //lo que warm no le pidio a esa Font a ese tamaño. Llamar antes del primer draw/getLocalBounds
+    void checkGlyph(const Font& font, Uint32 codepoint, unsigned size);
+    void checkText(const Text& text);
+    size_t warmedGlyphs() const;
+    size_t misses() const;
+    void report() const;
+private:
+    GlyphWarmup();
+    size_t warmed;
+    size_t missCount;
+    set<uint64_t> missed;
+    //Por Font: tamaño << 32 | codepoint de lo que ya tiene rasterizado
+    map<const Font*, set<uint64_t>> fontGlyphs;
+};
+
+#endif
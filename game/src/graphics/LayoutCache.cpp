@@ -0,0 +1,149 @@
+#include "LayoutCache.h"
+#include "../core/MappedFile.h"
+#include "../core/AtomicFile.h"
+#include "../core/Fnv.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+static const char LayoutMagic[4] = { 'R', 'L', 'A', 'Y' };
+
+LayoutCache& LayoutCache::getInstance() {
+    static LayoutCache instance;
+    return instance;
+}
+
+LayoutCache::LayoutCache()
+: capacity(4096),
+  hitCount(0),
+  missCount(0),
+  dirty(false)
+{
+}
+
+uint64_t LayoutCache::keyFor(const string& text, uint64_t fontHash, unsigned characterSize, Vector2f boxSize) {
+    //FNV-1a del texto y despues lo que cambia el corte
+    uint64_t h = fnv1a(text);
+    uint32_t w;
+    uint32_t ht;
+    memcpy(&w, &boxSize.x, 4);
+    memcpy(&ht, &boxSize.y, 4);
+    const uint64_t parts[] = { fontHash, characterSize, w, ht };
+    for (uint64_t p : parts) {
+        h = fnv1aMix(h, p);
+    }
+    return h;
+}
+
+bool LayoutCache::find(uint64_t key, size_t textLength, vector<TextLine>& lines) {
+    auto it = index.find(key);
+    if (it == index.end() || it->second->textLength != textLength) {
+        missCount++;
+        return false;
+    }
+    order.splice(order.begin(), order, it->second);
+    lines = it->second->lines;
+    hitCount++;
+    return true;
+}
+
+void LayoutCache::store(uint64_t key, size_t textLength, const vector<TextLine>& lines) {
+    auto it = index.find(key);
+    if (it != index.end()) {
+        order.erase(it->second);
+    }
+    order.push_front(Entry{ key, uint32_t(textLength), lines });
+    index[key] = order.begin();
+    dirty = true;
+    trim();
+}
+
+void LayoutCache::setCapacity(size_t entries) {
+    capacity = max<size_t>(1, entries);
+    trim();
+}
+
+void LayoutCache::trim() {
+    while (order.size() > capacity) {
+        index.erase(order.back().key);
+        order.pop_back();
+    }
+}
+
+bool LayoutCache::load(const string& path) {
+    MappedFile file;
+    if (!file.open(path)){return false;}
+    LayoutCacheHeader h;
+    if (file.size() < sizeof(h)){return false;}
+    memcpy(&h, file.data(), sizeof(h));
+    if (memcmp(h.magic, LayoutMagic, 4) != 0 || h.version != Version) {
+        cout << "[Layout] " << path << " es de otra version, se descarta" << endl;
+        return false;
+    }
+    const char* p = file.data() + sizeof(h);
+    const char* end = file.data() + file.size();
+    size_t loaded = 0;
+    //Vienen de la mas usada a la menos: se agregan atras para conservar el orden
+    for (uint32_t i = 0; i < h.entryCount && order.size() < capacity; ++i) {
+        LayoutCacheEntry e;
+        if (size_t(end - p) < sizeof(e)){break;}
+        memcpy(&e, p, sizeof(e));
+        p += sizeof(e);
+        if (uint64_t(end - p) < uint64_t(e.lineCount) * sizeof(LayoutCacheLine)){break;}
+        Entry entry{ e.key, e.textLength, vector<TextLine>() };
+        entry.lines.reserve(e.lineCount);
+        bool valid = true;
+        for (uint32_t l = 0; l < e.lineCount; ++l) {
+            LayoutCacheLine line;
+            memcpy(&line, p, sizeof(line));
+            p += sizeof(line);
+            valid = valid && line.begin <= line.end && line.end <= e.textLength;
+            entry.lines.push_back(TextLine{ line.begin, line.end, line.width });
+        }
+        if (!valid || index.count(e.key)){continue;}
+        order.push_back(move(entry));
+        index[e.key] = prev(order.end());
+        loaded++;
+    }
+    cout << "[Layout] " << loaded << " cortes de dialogo cargados de " << path << endl;
+    return true;
+}
+
+bool LayoutCache::save(const string& path) {
+    if (!dirty){return true;}
+    LayoutCacheHeader h;
+    memcpy(h.magic, LayoutMagic, 4);
+    h.version = Version;
+    h.entryCount = uint32_t(order.size());
+    h.reserved = 0;
+    bool ok = writeFileAtomic(path, [&](ofstream& f) {
+        f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        for (const auto& entry : order) {
+            LayoutCacheEntry e{ entry.key, entry.textLength, uint32_t(entry.lines.size()) };
+            f.write(reinterpret_cast<const char*>(&e), sizeof(e));
+            for (const auto& line : entry.lines) {
+                LayoutCacheLine rec{ uint32_t(line.begin), uint32_t(line.end), line.width };
+                f.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+            }
+        }
+    });
+    if (ok){dirty = false;}
+    return ok;
+}
+
+size_t LayoutCache::hits() const {
+    return hitCount;
+}
+
+size_t LayoutCache::misses() const {
+    return missCount;
+}
+
+void LayoutCache::report() const {
+    size_t total = hitCount + missCount;
+    cout << "[Layout] Cortes reusados: " << hitCount << " de " << total;
+    if (total > 0) {
+        cout << " (" << (100 * hitCount / total) << "%)";
+    }
+    cout << ", " << order.size() << " en cache" << endl;
+}
@@ -0,0 +1,71 @@
+#ifndef LAYOUT_CACHE_H
+#define LAYOUT_CACHE_H
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include "TextLayout.h"
+using namespace std;
+using namespace sf;
+
+//Archivo de la cache: cabecera + por entrada {key, largo del texto, cantidad de lineas} + lineas
+#pragma pack(push, 1)
+struct LayoutCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+struct LayoutCacheEntry {
+    uint64_t key;
+    uint32_t textLength;
+    uint32_t lineCount;
+};
+struct LayoutCacheLine {
+    uint32_t begin;
+    uint32_t end;
+    float width;
+};
+#pragma pack(pop)
+
+//Cortes de linea ya calculados de los dialogos, por hash de texto + fuente + tamaño + caja
+//LRU en memoria; se guarda al salir y se lee al iniciar (solo hilo principal)
+class LayoutCache {
+public:
+    //Subirla si cambia el algoritmo de corte: invalida los archivos viejos
+    static const uint32_t Version = 1;
+    static LayoutCache& getInstance();
+    //fontHash: hash del contenido del ttf (ResourceManager::getFontHash), no de la ruta
+    static uint64_t keyFor(const string& text, uint64_t fontHash, unsigned characterSize, Vector2f boxSize);
+    //True y lines con el corte guardado; textLength descarta colisiones obvias
+    bool find(uint64_t key, size_t textLength, vector<TextLine>& lines);
+    void store(uint64_t key, size_t textLength, const vector<TextLine>& lines);
+    void setCapacity(size_t entries);
+    //Archivo vacio o de otra version: se empieza de cero
+    bool load(const string& path);
+    //Solo escribe si hubo cortes nuevos
+    bool save(const string& path);
+    size_t hits() const;
+    size_t misses() const;
+    void report() const;
+private:
+    LayoutCache();
+    struct Entry {
+        uint64_t key;
+        uint32_t textLength;
+        vector<TextLine> lines;
+    };
+    //Frente = lo ultimo usado
+    list<Entry> order;
+    unordered_map<uint64_t, list<Entry>::iterator> index;
+    size_t capacity;
+    size_t hitCount;
+    size_t missCount;
+    bool dirty;
+    void trim();
+};
+
+#endif
@@ -1,8 +1,6 @@
 #include "SpriteAnimator.hpp"
 
 SpriteAnimator::SpriteAnimator() {
-    texA = nullptr;
-    texB = nullptr;
     sprite = nullptr;
     frameDuration = 1.0f / 8.0f; //Default 8 fps
     timer = 0.0f;
@@ -12,17 +10,21 @@ SpriteAnimator::SpriteAnimator() {
 
 void SpriteAnimator::attachSprite(Sprite* s) {
     sprite = s;
-    //Si ya tenemos texA, asignarla al sprite inmediatamente
-    if (sprite && texA) {
-        sprite->setTexture(*texA);
+    //Si ya tenemos el frame A, asignarla al sprite inmediatamente
+    if (sprite && frameA) {
+        applyRegion(*sprite, frameA);
     }
 }
 
 void SpriteAnimator::loadFrames(const Texture* a, const Texture* b) {
-    texA = a;
-    texB = b;
-    if (sprite && texA) {
-        sprite->setTexture(*texA);
+    loadFrames(a ? wholeTexture(*a) : AtlasRegion(), b ? wholeTexture(*b) : AtlasRegion());
+}
+
+void SpriteAnimator::loadFrames(const AtlasRegion& a, const AtlasRegion& b) {
+    frameA = a;
+    frameB = b;
+    if (sprite && frameA) {
+        applyRegion(*sprite, frameA);
         usingA = true;
     }
 }
@@ -40,8 +42,8 @@ void SpriteAnimator::play() {
     //Asegura estado inicial
     timer = 0.0f;
     usingA = true;
-    if (sprite && texA){
-    	sprite->setTexture(*texA);
+    if (sprite && frameA){
+    	applyRegion(*sprite, frameA);
 	}
 }
 
@@ -50,15 +52,11 @@ void SpriteAnimator::stop() {
 }
 
 void SpriteAnimator::update(float dt) {
-    if (!playing || !sprite || !texA || !texB){return;}
+    if (!playing || !sprite || !frameA || !frameB){return;}
     timer += dt;
     if (timer >= frameDuration) {
         timer -= frameDuration;
         usingA = !usingA;
-        if (usingA){
-        	sprite->setTexture(*texA);
-		}else{
-			sprite->setTexture(*texB);
-		}
+        applyRegion(*sprite, usingA ? frameA : frameB);
     }
 }
@@ -2,13 +2,15 @@
 #define SPRITE_ANIMATOR_HPP
 
 #include <SFML/Graphics.hpp>
+#include "TextureAtlas.h"
 using namespace std;
 using namespace sf;
 
 class SpriteAnimator {
 private:
-    const Texture* texA;
-    const Texture* texB;
+    //Si los dos frames estan en la misma pagina del atlas solo cambia el rect
+    AtlasRegion frameA;
+    AtlasRegion frameB;
     Sprite* sprite;
     float frameDuration;
     float timer;
@@ -20,6 +22,7 @@ public:
 
     void attachSprite(Sprite* s);
     void loadFrames(const Texture* a, const Texture* b);
+    void loadFrames(const AtlasRegion& a, const AtlasRegion& b);
     void setFPS(int fps);
 
     void play();
@@ -27,4 +30,4 @@ public:
     void update(float dt);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,248 @@
+#include "TextLayout.h"
+#include "GlyphWarmup.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+GlyphMetrics& GlyphMetrics::get(const Font& font, unsigned characterSize) {
+    static map<pair<const Font*, unsigned>, unique_ptr<GlyphMetrics>> cache;
+    auto& slot = cache[make_pair(&font, characterSize)];
+    if (!slot) {
+        slot.reset(new GlyphMetrics(font, characterSize));
+    }
+    return *slot;
+}
+
+GlyphMetrics::GlyphMetrics(const Font& f, unsigned characterSize)
+: font(f),
+  size(characterSize),
+  primed(false)
+{
+    latin.fill(numeric_limits<float>::quiet_NaN());
+}
+
+float GlyphMetrics::advance(Uint32 codepoint) {
+    if (codepoint < latin.size()) {
+        float& a = latin[codepoint];
+        if (std::isnan(a)) {
+            a = fetch(codepoint);
+        }
+        return a;
+    }
+    auto it = others.find(codepoint);
+    if (it == others.end()) {
+        it = others.emplace(codepoint, fetch(codepoint)).first;
+    }
+    return it->second;
+}
+
+float GlyphMetrics::fetch(Uint32 codepoint) {
+    //Despues de prime, pedirle a la Font es rasterizar en medio del juego
+    if (primed && codepoint > ' ') {
+        GlyphWarmup::getInstance().countMiss(codepoint, size);
+    }
+    return font.getGlyph(codepoint, size, false).advance;
+}
+
+void GlyphMetrics::prime(const GlyphAtlas& atlas) {
+    for (Uint32 cp : atlas.codepoints()) {
+        const Glyph* glyph = atlas.find(cp, size);
+        if (!glyph){continue;}
+        if (cp < latin.size()) {
+            latin[cp] = glyph->advance;
+        } else {
+            others[cp] = glyph->advance;
+        }
+    }
+    primed = true;
+}
+
+float GlyphMetrics::kerning(Uint32 first, Uint32 second) {
+    if (first == 0){return 0.f;}
+    uint64_t key = (uint64_t(first) << 32) | second;
+    auto it = kernings.find(key);
+    if (it == kernings.end()) {
+        it = kernings.emplace(key, font.getKerning(first, second, size)).first;
+    }
+    return it->second;
+}
+
+Uint32 TextLayout::decodeUtf8(const string& utf8, size_t& i) {
+    unsigned char c = static_cast<unsigned char>(utf8[i++]);
+    size_t extra = 0;
+    Uint32 cp = c;
+    if ((c & 0xE0) == 0xC0) {extra = 1; cp = c & 0x1F;}
+    else if ((c & 0xF0) == 0xE0) {extra = 2; cp = c & 0x0F;}
+    else if ((c & 0xF8) == 0xF0) {extra = 3; cp = c & 0x07;}
+    if (i + extra > utf8.size()){return c;}
+    for (size_t k = 0; k < extra; ++k) {
+        unsigned char next = static_cast<unsigned char>(utf8[i + k]);
+        if ((next & 0xC0) != 0x80){return c;}
+        cp = (cp << 6) | (next & 0x3F);
+    }
+    i += extra;
+    return cp;
+}
+
+float TextLayout::measure(const string& utf8, GlyphMetrics& metrics) {
+    float width = 0.f;
+    Uint32 prev = 0;
+    for (size_t i = 0; i < utf8.size();) {
+        Uint32 cp = decodeUtf8(utf8, i);
+        width += metrics.kerning(prev, cp) + metrics.advance(cp);
+        prev = cp;
+    }
+    return width;
+}
+
+void TextLayout::breakLines(const string& utf8, GlyphMetrics* metrics, float maxWidth, vector<TextLine>& out) {
+    out.clear();
+    size_t lineStart = 0;
+    //Ancho de [lineStart, i) contando los espacios del final
+    float width = 0.f;
+    Uint32 prev = 0;
+    //Ultima tanda de espacios: la linea termina en breakAt y la siguiente empieza en afterBreak
+    size_t breakAt = string::npos;
+    size_t afterBreak = 0;
+    float widthAtBreak = 0.f;
+    float widthAfterBreak = 0.f;
+    auto emit = [&](size_t end) {
+        //Los espacios del final no cuentan
+        bool trailing = prev == ' ' && breakAt != string::npos;
+        out.push_back(TextLine{ lineStart, trailing ? breakAt : end, trailing ? widthAtBreak : width });
+    };
+    auto measureStep = [&](Uint32 first, Uint32 second) {
+        return metrics ? metrics->kerning(first, second) + metrics->advance(second) : 0.f;
+    };
+    for (size_t i = 0; i < utf8.size();) {
+        size_t at = i;
+        Uint32 cp = decodeUtf8(utf8, i);
+        if (cp == '\n') {
+            emit(at);
+            lineStart = i;
+            width = 0.f;
+            prev = 0;
+            breakAt = string::npos;
+            continue;
+        }
+        if (cp == ' ') {
+            //Los espacios al inicio de una linea no ocupan lugar
+            if (at == lineStart) {
+                lineStart = i;
+                continue;
+            }
+            if (prev != ' ') {
+                breakAt = at;
+                widthAtBreak = width;
+            }
+            afterBreak = i;
+            widthAfterBreak = 0.f;
+            width += measureStep(prev, cp);
+            prev = cp;
+            continue;
+        }
+        float adv = measureStep(prev, cp);
+        while (width + adv > maxWidth && at > lineStart) {
+            if (breakAt != string::npos) {
+                //La palabra actual baja entera a la linea siguiente
+                out.push_back(TextLine{ lineStart, breakAt, widthAtBreak });
+                lineStart = afterBreak;
+                width = widthAfterBreak;
+                breakAt = string::npos;
+            } else {
+                //Palabra mas ancha que la caja: se corta antes de este caracter
+                out.push_back(TextLine{ lineStart, at, width });
+                lineStart = at;
+                width = 0.f;
+                adv = measureStep(0, cp);
+            }
+        }
+        width += adv;
+        widthAfterBreak += adv;
+        prev = cp;
+    }
+    if (lineStart < utf8.size()) {
+        emit(utf8.size());
+    }
+}
+
+namespace {
+//De donde salen los glifos: la Font (su pagina de ese tamaño) o el atlas prearmado
+struct FontGlyphs {
+    const Font& font;
+    unsigned size;
+    const Glyph* glyph(Uint32 codepoint) const {
+        GlyphWarmup::getInstance().checkGlyph(font, codepoint, size);
+        return &font.getGlyph(codepoint, size, false);
+    }
+    float kerning(Uint32 first, Uint32 second) const { return font.getKerning(first, second, size); }
+    float lineSpacing() const { return font.getLineSpacing(size); }
+};
+
+struct AtlasGlyphs {
+    const GlyphAtlas& atlas;
+    unsigned size;
+    const Glyph* glyph(Uint32 codepoint) const {
+        const Glyph* g = atlas.find(codepoint, size);
+        if (g){return g;}
+        //Fuera del charset: se ve un '?' en vez de un hueco
+        GlyphWarmup::getInstance().countMiss(codepoint, size);
+        return atlas.find('?', size);
+    }
+    float kerning(Uint32 first, Uint32 second) const { return atlas.kerning(first, second, size); }
+    float lineSpacing() const { return atlas.lineSpacing(size); }
+};
+
+//Mismo recorrido que Text::ensureGeometryUpdate (sin estilos)
+template <typename Glyphs>
+float appendRun(const string& utf8, const Glyphs& source, unsigned characterSize, float lineSpacing, Color color, GlyphRun& out, Vector2f origin) {
+    out.vertices.reserve(out.vertices.size() + utf8.size() * 6);
+    out.vertexEnd.reserve(out.vertexEnd.size() + utf8.size());
+    const Glyph* space = source.glyph(' ');
+    float whitespace = space ? space->advance : 0.f;
+    float lineHeight = source.lineSpacing() * lineSpacing;
+    float x = 0.f;
+    float y = static_cast<float>(characterSize);
+    float widest = 0.f;
+    Uint32 prev = 0;
+    for (size_t i = 0; i < utf8.size();) {
+        Uint32 cp = TextLayout::decodeUtf8(utf8, i);
+        x += source.kerning(prev, cp);
+        prev = cp;
+        const Glyph* glyph = nullptr;
+        if (cp == ' '){x += whitespace;}
+        else if (cp == '\t'){x += whitespace * 4;}
+        else if (cp == '\n'){widest = max(widest, x); y += lineHeight; x = 0.f;}
+        else {glyph = source.glyph(cp);}
+        if (glyph) {
+            //1px de margen como Text, para que el filtrado no corte los bordes
+            const float padding = 1.f;
+            float left = origin.x + x + glyph->bounds.left - padding;
+            float top = origin.y + y + glyph->bounds.top - padding;
+            float right = origin.x + x + glyph->bounds.left + glyph->bounds.width + padding;
+            float bottom = origin.y + y + glyph->bounds.top + glyph->bounds.height + padding;
+            float u1 = static_cast<float>(glyph->textureRect.left) - padding;
+            float v1 = static_cast<float>(glyph->textureRect.top) - padding;
+            float u2 = static_cast<float>(glyph->textureRect.left + glyph->textureRect.width) + padding;
+            float v2 = static_cast<float>(glyph->textureRect.top + glyph->textureRect.height) + padding;
+            out.vertices.push_back(Vertex(Vector2f(left, top), color, Vector2f(u1, v1)));
+            out.vertices.push_back(Vertex(Vector2f(right, top), color, Vector2f(u2, v1)));
+            out.vertices.push_back(Vertex(Vector2f(left, bottom), color, Vector2f(u1, v2)));
+            out.vertices.push_back(Vertex(Vector2f(left, bottom), color, Vector2f(u1, v2)));
+            out.vertices.push_back(Vertex(Vector2f(right, top), color, Vector2f(u2, v1)));
+            out.vertices.push_back(Vertex(Vector2f(right, bottom), color, Vector2f(u2, v2)));
+            x += glyph->advance;
+        }
+        out.vertexEnd.push_back(static_cast<uint32_t>(out.vertices.size()));
+    }
+    return max(widest, x);
+}
+}
+
+float TextLayout::buildGlyphRun(const string& utf8, const Font& font, unsigned characterSize, float lineSpacing, Color color, GlyphRun& out, Vector2f origin) {
+    return appendRun(utf8, FontGlyphs{ font, characterSize }, characterSize, lineSpacing, color, out, origin);
+}
+
+float TextLayout::buildGlyphRun(const string& utf8, const GlyphAtlas& atlas, unsigned characterSize, float lineSpacing, Color color, GlyphRun& out, Vector2f origin) {
+    return appendRun(utf8, AtlasGlyphs{ atlas, characterSize }, characterSize, lineSpacing, color, out, origin);
+}
@@ -0,0 +1,68 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <array>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include "GlyphAtlas.h"
+using namespace std;
+using namespace sf;
+
+//Avances y kerning de una fuente a un tamaño: se le piden a la Font una sola vez
+//Compartidas entre cajas de dialogo (solo hilo principal; la Font tiene que vivir mas)
+class GlyphMetrics {
+public:
+    static GlyphMetrics& get(const Font& font, unsigned characterSize);
+    float advance(Uint32 codepoint);
+    float kerning(Uint32 first, Uint32 second);
+    unsigned characterSize() const { return size; }
+    //Copia los avances del atlas: lo que no este ahi cuenta como glifo sin precalentar
+    void prime(const GlyphAtlas& atlas);
+private:
+    GlyphMetrics(const Font& font, unsigned characterSize);
+    const Font& font;
+    unsigned size;
+    //Latin-1 (incluye á, ñ, ¿, ¡) en tabla; el resto en el mapa. NaN = sin pedir todavia
+    array<float, 256> latin;
+    unordered_map<Uint32, float> others;
+    unordered_map<uint64_t, float> kernings;
+    bool primed;
+    float fetch(Uint32 codepoint);
+};
+
+//Rango de bytes de una linea dentro del texto utf8 (sin el salto ni los espacios del corte)
+struct TextLine {
+    size_t begin;
+    size_t end;
+    float width;
+};
+
+//Glifos de uno o mas textos, con los mismos quads que arma sf::Text (6 vertices por glifo visible)
+//vertexEnd[i] = cuantos vertices dibujar para mostrar hasta el codepoint i inclusive
+struct GlyphRun {
+    vector<Vertex> vertices;
+    vector<uint32_t> vertexEnd;
+    size_t length() const { return vertexEnd.size(); }
+};
+
+//Corte de lineas en una pasada: cada caracter se mide una vez, sin armar sf::Text
+class TextLayout {
+public:
+    //Corta en el ultimo espacio que entra; una palabra mas ancha que maxWidth se corta por caracter
+    //Sin metrics todo mide 0 (solo cortan los \n)
+    static void breakLines(const string& utf8, GlyphMetrics* metrics, float maxWidth, vector<TextLine>& out);
+    //Agrega los quads a out con la esquina del texto en origin (como Text::setPosition); devuelve el ancho
+    //lineSpacing es el factor (como Text::setLineSpacing). Con Font: textura font.getTexture(characterSize)
+    static float buildGlyphRun(const string& utf8, const Font& font, unsigned characterSize, float lineSpacing, Color color, GlyphRun& out, Vector2f origin = Vector2f());
+    //Con el atlas: todos los tamaños en atlas.getTexture(), un solo draw para textos distintos
+    static float buildGlyphRun(const string& utf8, const GlyphAtlas& atlas, unsigned characterSize, float lineSpacing, Color color, GlyphRun& out, Vector2f origin = Vector2f());
+    static float measure(const string& utf8, GlyphMetrics& metrics);
+    //Siguiente codepoint desde i (avanza i); bytes invalidos se toman de a uno
+    static Uint32 decodeUtf8(const string& utf8, size_t& i);
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <iostream>
+
+AtlasRegion wholeTexture(const Texture& texture) {
+    AtlasRegion region;
+    region.texture = &texture;
+    Vector2u size = texture.getSize();
+    region.rect = IntRect(0, 0, size.x, size.y);
+    return region;
+}
+
+void applyRegion(Sprite& sprite, const AtlasRegion& region) {
+    if (!region){return;}
+    if (sprite.getTexture() != region.texture) {
+        sprite.setTexture(*region.texture);
+    }
+    sprite.setTextureRect(region.rect);
+}
+
+TextureAtlas::TextureAtlas(unsigned size, unsigned pad)
+: pageSize(min(size, Texture::getMaximumSize())),
+  padding(pad),
+  totalBytes(0)
+{
+}
+
+bool TextureAtlas::add(ResourceId id, const Image& image) {
+    Vector2u size = image.getSize();
+    if (!id || size.x == 0 || size.y == 0){return false;}
+    if (size.x > pageSize || size.y > pageSize){return false;}
+    if (regions.count(id)){return true;}
+    pending.push_back(Pending{ id, image });
+    return true;
+}
+
+bool TextureAtlas::build() {
+    if (pending.empty()){return true;}
+    //Mas altas primero: los estantes quedan parejos y se desperdicia menos
+    sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) {
+        Vector2u sa = a.image.getSize();
+        Vector2u sb = b.image.getSize();
+        return sa.y != sb.y ? sa.y > sb.y : sa.x > sb.x;
+    });
+    struct Placement {
+        size_t page;
+        unsigned x;
+        unsigned y;
+    };
+    vector<Placement> placements;
+    vector<Vector2u> pageSizes(1, Vector2u(0, 0));
+    unsigned x = 0, y = 0, shelfHeight = 0;
+    for (const auto& p : pending) {
+        Vector2u size = p.image.getSize();
+        if (x + size.x > pageSize) {
+            //Siguiente estante
+            y += shelfHeight;
+            x = 0;
+            shelfHeight = 0;
+        }
+        if (y + size.y > pageSize) {
+            //Siguiente pagina
+            pageSizes.push_back(Vector2u(0, 0));
+            x = y = shelfHeight = 0;
+        }
+        placements.push_back(Placement{ pageSizes.size() - 1, x, y });
+        Vector2u& used = pageSizes.back();
+        used.x = max(used.x, x + size.x);
+        used.y = max(used.y, y + size.y);
+        x += size.x + padding;
+        shelfHeight = max(shelfHeight, size.y + padding);
+    }
+    //Cada pagina se recorta a lo que realmente usa
+    size_t firstPage = pages.size();
+    vector<Image> pageImages(pageSizes.size());
+    for (size_t i = 0; i < pageSizes.size(); ++i) {
+        pageImages[i].create(pageSizes[i].x, pageSizes[i].y, Color::Transparent);
+    }
+    for (size_t i = 0; i < pending.size(); ++i) {
+        const Placement& at = placements[i];
+        pageImages[at.page].copy(pending[i].image, at.x, at.y);
+    }
+    bool ok = true;
+    vector<bool> uploaded(pageImages.size(), false);
+    for (size_t i = 0; i < pageImages.size(); ++i) {
+        auto page = make_unique<Texture>();
+        uploaded[i] = page->loadFromImage(pageImages[i]);
+        if (uploaded[i]) {
+            totalBytes += size_t(pageSizes[i].x) * pageSizes[i].y * 4;
+        } else {
+            //Lo de esta pagina queda fuera del atlas y se carga suelto
+            cout << "ERROR: No se pudo subir pagina del atlas (" << pageSizes[i].x << "x" << pageSizes[i].y << ")" << endl;
+            ok = false;
+        }
+        pages.push_back(move(page));
+    }
+    for (size_t i = 0; i < pending.size(); ++i) {
+        const Placement& at = placements[i];
+        if (!uploaded[at.page]){continue;}
+        Vector2u size = pending[i].image.getSize();
+        AtlasRegion region;
+        region.texture = pages[firstPage + at.page].get();
+        region.rect = IntRect(at.x, at.y, size.x, size.y);
+        regions[pending[i].id] = region;
+    }
+    pending.clear();
+    return ok;
+}
+
+AtlasRegion TextureAtlas::find(ResourceId id) const {
+    auto it = regions.find(id);
+    return it != regions.end() ? it->second : AtlasRegion();
+}
+
+size_t TextureAtlas::pageCount() const {
+    return pages.size();
+}
+
+size_t TextureAtlas::size() const {
+    return regions.size();
+}
+
+size_t TextureAtlas::bytes() const {
+    return totalBytes;
+}
@@ -0,0 +1,53 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "../core/ResourceId.h"
+using namespace std;
+using namespace sf;
+
+//Un rectangulo dentro de una textura (pagina del atlas o textura suelta entera)
+struct AtlasRegion {
+    const Texture* texture = nullptr;
+    IntRect rect;
+    explicit operator bool() const { return texture != nullptr; }
+};
+
+//Region que ocupa toda la textura
+AtlasRegion wholeTexture(const Texture& texture);
+//Cambia solo el rect si el sprite ya usa esa pagina (sin cambio de textura al dibujar)
+void applyRegion(Sprite& sprite, const AtlasRegion& region);
+
+//Empaqueta imagenes chicas (frames de personajes, botones) en pocas paginas compartidas
+//Por estantes: ordenadas por alto, se llenan filas de izquierda a derecha
+class TextureAtlas {
+public:
+    explicit TextureAtlas(unsigned pageSize = 2048, unsigned padding = 2);
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+    //Copia la imagen decodificada; no sube nada hasta build(). False si no entra en una pagina
+    bool add(ResourceId id, const Image& image);
+    //Empaqueta lo agregado y sube las paginas nuevas a la GPU
+    bool build();
+    AtlasRegion find(ResourceId id) const;
+    size_t pageCount() const;
+    size_t size() const;
+    size_t bytes() const;
+private:
+    struct Pending {
+        ResourceId id;
+        Image image;
+    };
+    unsigned pageSize;
+    unsigned padding;
+    vector<Pending> pending;
+    //unique_ptr: las regiones apuntan a las paginas
+    vector<unique_ptr<Texture>> pages;
+    unordered_map<ResourceId, AtlasRegion, ResourceIdHash> regions;
+    size_t totalBytes;
+};
+
+#endif
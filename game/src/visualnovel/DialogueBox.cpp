@@ -1,4 +1,6 @@
 #include "DialogueBox.h"
+#include "../graphics/LayoutCache.h"
+#include "../graphics/GlyphWarmup.h"
 #include <iostream>
 #include <locale>
 #include <codecvt>
@@ -17,13 +19,15 @@ wstring DialogueBox::utf8_to_wstring(const string& str) {
 }
 
 DialogueBox::DialogueBox(ResourceManager& res,
-                         const string& fontPath,
+                         ResourceId fontId,
                          const Vector2f& size,
                          const Vector2f& position,
-                         const string& bgTexturePath,
-                         const string& voicePath)
+                         ResourceId bgTexture,
+                         VoiceBank* voiceBank)
 : resources(res),
   font(nullptr),
+  fontHash(0),
+  glyphAtlas(nullptr),
   usingSpriteBackground(false),
   boxSize(size),
   boxPosition(position),
@@ -33,21 +37,23 @@ DialogueBox::DialogueBox(ResourceManager& res,
   finishedTyping(true),
   active(false),
   currentPageIndex(0),
-  voiceFilePath(voicePath)
+  hintVertices(0),
+  voices(voiceBank)
 {
     //Intentar cargar la fuente
     try {
-        font = &resources.getFont(fontPath);
+        font = &resources.getFont(fontId);
+        fontHash = resources.getFontHash(fontId);
     } catch (exception& e) {
         cout << "[System] Error cargando fuente: " << e.what() << endl;
         font = nullptr;
     }
     //Intentar cargar sprite de fondo
-    if (!bgTexturePath.empty()) {
+    if (bgTexture) {
         try {
-            Texture& t = resources.getTexture(bgTexturePath);
-            backgroundSprite.setTexture(t);
-            Vector2u texSize = t.getSize();
+            AtlasRegion region = resources.getRegion(bgTexture);
+            applyRegion(backgroundSprite, region);
+            Vector2u texSize(region.rect.width, region.rect.height);
             if (texSize.x > 0 && texSize.y > 0) {
                 float sx = boxSize.x / static_cast<float>(texSize.x);
                 float sy = boxSize.y / static_cast<float>(texSize.y);
@@ -56,7 +62,7 @@ DialogueBox::DialogueBox(ResourceManager& res,
             backgroundSprite.setPosition(boxPosition);
             usingSpriteBackground = true;
         } catch (exception& e) {
-            cout << "[System] No se pudo cargar bg sprite: " << bgTexturePath << " -> " << e.what() << endl;
+            cout << "[System] No se pudo cargar bg sprite: " << bgTexture.path() << " -> " << e.what() << endl;
             usingSpriteBackground = false;
         }
     }
@@ -86,161 +92,116 @@ DialogueBox::DialogueBox(ResourceManager& res,
         hintText.setPosition(boxPosition.x + boxSize.x - 220.f, boxPosition.y + boxSize.y - 32.f);
         hintText.setString( utf8_to_wstring(std::string("Presiona Space / Click")) );
         hintText.setFillColor(Color(0, 0, 0,180));
+        //El atlas tiene que traer los tres tamaños de la caja
+        glyphAtlas = resources.findGlyphAtlas(fontId);
+        if (glyphAtlas && !(glyphAtlas->hasSize(speakerText.getCharacterSize()) && glyphAtlas->hasSize(bodyText.getCharacterSize())
+                            && glyphAtlas->hasSize(hintText.getCharacterSize()))) {
+            glyphAtlas = nullptr;
+        }
+        //Sin atlas el hint se dibuja con la Font
+        if (!glyphAtlas) {
+            GlyphWarmup::getInstance().checkText(hintText);
+        }
     } else {
         cout << "[System] No se encontró una fuente válida. El texto puede no mostrarse.\n";
     }
-    //Intentar cargar voice blip
-    if (!voiceFilePath.empty()) {
-        if (!voiceBlip.loadFromFile(voiceFilePath)) {
-            //Si falla, simplemente no se reproducira sonido
-            cout << "[System] No se pudo cargar voice blip: " << voiceFilePath << endl;
-        }
-    }
-}
-
-float DialogueBox::measureWidthUtf8(const string& utf8) const {
-    if (!font) return 0.f;
-    wstring w = utf8_to_wstring(utf8);
-    Text tmp;
-    tmp.setFont(*font);
-    tmp.setCharacterSize(bodyText.getCharacterSize());
-    tmp.setString(w);
-    FloatRect r = tmp.getLocalBounds();
-    return r.width;
 }
 
 void DialogueBox::buildPages() {
     pages.clear();
-    currentPageIndex = 0;
+    showPage(0);
     if (fullText.empty()){return;}
     float maxWidth = boxSize.x - 24.f;
     float availableHeight = (boxPosition.y + boxSize.y) - bodyText.getPosition().y - 12.f;
     float lineHeight = static_cast<float>(bodyText.getCharacterSize()) * 1.2f; // factor de interlineado
     int maxLinesPerPage = std::max(1, static_cast<int>(std::floor(availableHeight / lineHeight)));
-    //Mantener espacios y saltos de linea)
-    vector<string> words;
-    {
-        string token;
-        for (size_t i = 0; i < fullText.size();) {
-            char c = fullText[i];
-            if (c == '\n') {
-                if (!token.empty()) { words.push_back(token); token.clear(); }
-                words.push_back("\n");
-                ++i;
-            } else if (c == ' ') {
-                if (!token.empty()) { words.push_back(token); token.clear(); }
-                words.push_back(" ");
-                ++i;
-            } else {
-                unsigned char uc = static_cast<unsigned char>(c);
-                size_t charBytes = 1;
-                if ((uc & 0x80) == 0x00) charBytes = 1;
-                else if ((uc & 0xE0) == 0xC0) charBytes = 2;
-                else if ((uc & 0xF0) == 0xE0) charBytes = 3;
-                else if ((uc & 0xF8) == 0xF0) charBytes = 4;
-                for (size_t b = 0; b < charBytes && i < fullText.size(); ++b, ++i) token.push_back(fullText[i]);
-            }
+    //Lineas ya vistas (en esta partida o en otra): el corte sale de LayoutCache
+    vector<TextLine> lines;
+    LayoutCache& layouts = LayoutCache::getInstance();
+    uint64_t layoutKey = LayoutCache::keyFor(fullText, fontHash, bodyText.getCharacterSize(), boxSize);
+    bool cacheable = font && fontHash;
+    if (!cacheable || !layouts.find(layoutKey, fullText.size(), lines)) {
+        //Una pasada con los anchos cacheados (mantiene espacios y saltos de linea)
+        GlyphMetrics* metrics = font ? &GlyphMetrics::get(*font, bodyText.getCharacterSize()) : nullptr;
+        TextLayout::breakLines(fullText, metrics, maxWidth, lines);
+        if (cacheable) {
+            layouts.store(layoutKey, fullText.size(), lines);
         }
-        if (!token.empty()) words.push_back(token);
     }
-    vector<string> lines;
-    string curLine;
-    for (size_t i = 0; i < words.size(); ++i) {
-        string w = words[i];
-        if (w == "\n") {
-            lines.push_back(curLine);
-            curLine.clear();
-            continue;
-        } else if (w == " ") {
-            if (!curLine.empty()) curLine.push_back(' ');
-            continue;
-        } else {
-            string trial = curLine;
-            if (!trial.empty()) trial.push_back(' ');
-            trial += w;
-            float wpx = measureWidthUtf8(trial);
-            if (wpx <= maxWidth) {
-                if (!curLine.empty()) curLine.push_back(' ');
-                curLine += w;
-            } else {
-                if (curLine.empty()) {
-                    //Rompe!!!
-                    string piece;
-                    for (size_t idx = 0; idx < w.size();) {
-                        unsigned char uc = static_cast<unsigned char>(w[idx]);
-                        size_t charBytes = 1;
-                        if ((uc & 0x80) == 0x00) charBytes = 1;
-                        else if ((uc & 0xE0) == 0xC0) charBytes = 2;
-                        else if ((uc & 0xF0) == 0xE0) charBytes = 3;
-                        else if ((uc & 0xF8) == 0xF0) charBytes = 4;
-                        string nextPiece = piece + w.substr(idx, charBytes);
-                        if (measureWidthUtf8(nextPiece) <= maxWidth) {
-                            piece = nextPiece;
-                            idx += charBytes;
-                        } else {
-                            break;
-                        }
-                    }
-                    if (!piece.empty()) {
-                        lines.push_back(piece);
-                        string rem = w.substr(piece.size());
-                        if (!rem.empty()) {
-                            words.insert(words.begin() + i + 1, rem);
-                        }
-                        curLine.clear();
-                    } else {
-                        lines.push_back(w);
-                        curLine.clear();
-                    }
-                } else {
-                    lines.push_back(curLine);
-                    curLine = w;
-                }
-            }
-        }
-    }
-    if (!curLine.empty()) lines.push_back(curLine);
     //Agrupa en paginas
     string pageAccum;
     int lineCount = 0;
     for (size_t i = 0; i < lines.size(); ++i) {
         if (lineCount >= maxLinesPerPage) {
-            pages.push_back(pageAccum);
+            addPage(pageAccum);
             pageAccum.clear();
             lineCount = 0;
         }
         if (!pageAccum.empty()) pageAccum += "\n";
-        pageAccum += lines[i];
+        pageAccum.append(fullText, lines[i].begin, lines[i].end - lines[i].begin);
         lineCount++;
     }
     if (!pageAccum.empty()){
-    	pages.push_back(pageAccum);	
+    	addPage(pageAccum);	
 	}
     if (pages.empty()){
-   		pages.push_back(string(""));	
+   		addPage(string(""));	
 	}
     //Prepara primera pagina
-    currentPageIndex = 0;
-    currentShownText.clear();
+    showPage(0);
+}
+
+void DialogueBox::addPage(const string& text) {
+    pages.emplace_back();
+    if (glyphAtlas) {
+        TextLayout::buildGlyphRun(text, *glyphAtlas, bodyText.getCharacterSize(), bodyText.getLineSpacing(), bodyText.getFillColor(), pages.back(), bodyText.getPosition());
+    } else if (font) {
+        TextLayout::buildGlyphRun(text, *font, bodyText.getCharacterSize(), bodyText.getLineSpacing(), bodyText.getFillColor(), pages.back(), bodyText.getPosition());
+    }
+}
+
+void DialogueBox::buildChrome(const string& speaker) {
+    chrome.vertices.clear();
+    chrome.vertexEnd.clear();
+    if (!glyphAtlas){return;}
+    //El hint va primero: mientras escribe se dibuja desde el speaker
+    TextLayout::buildGlyphRun("Presiona Space / Click", *glyphAtlas, hintText.getCharacterSize(), 1.f, hintText.getFillColor(), chrome, hintText.getPosition());
+    hintVertices = chrome.vertices.size();
+    TextLayout::buildGlyphRun(speaker, *glyphAtlas, speakerText.getCharacterSize(), 1.f, speakerText.getFillColor(), chrome, speakerText.getPosition());
+}
+
+void DialogueBox::showPage(size_t index) {
+    currentPageIndex = index;
     charIndexInPage = 0;
     finishedTyping = false;
+    if (!glyphAtlas){return;}
+    textLayer.vertices = chrome.vertices;
+    if (index < pages.size()) {
+        textLayer.vertices.insert(textLayer.vertices.end(), pages[index].vertices.begin(), pages[index].vertices.end());
+    }
 }
 
 void DialogueBox::setDialogue(const string& speaker, const string& text) {
     if (font){
 		speakerText.setString( utf8_to_wstring(speaker) );	
+		if (!glyphAtlas) {
+			GlyphWarmup::getInstance().checkText(speakerText);
+		}
 	}
     fullText = text;
+    buildChrome(speaker);
     buildPages();
-    currentShownText.clear();
     charTimer = 0.f;
     charIndexInPage = 0;
     finishedTyping = false;
     active = true;
-    //Mostrar vacio y empezar typewriter
-    if (font){
-    	bodyText.setString( utf8_to_wstring(string("")) );	
-	}
+    //Voz del personaje: el buffer es del banco, aca no se decodifica nada
+    if (voices) {
+        VoiceProfile profile = voices->profileFor(speaker);
+        SoundHandle blip = voices->buffer(profile.blip);
+        voiceBlip.setVoice(blip.get(), profile.pitch, profile.timbre);
+        voiceBuffer = move(blip);
+    }
     //Iniciar sonido de blip
     voiceBlip.playLoop();
 }
@@ -249,22 +210,16 @@ void DialogueBox::advance() {
     if (!active){return;}
     if (!finishedTyping) {
         //Mostrar pagina completa
-        currentShownText = pages[currentPageIndex];
-        charIndexInPage = currentShownText.size();
+        charIndexInPage = pages[currentPageIndex].length();
         finishedTyping = true;
-        if (font) bodyText.setString( utf8_to_wstring(currentShownText) );
         //Detener blip
         voiceBlip.stop();
     } else {
         //La pagina ya completa
         if (currentPageIndex + 1 < pages.size()) {
             //Ir a siguiente pagina y reiniciar typewriter
-            currentPageIndex++;
-            currentShownText.clear();
-            charIndexInPage = 0;
-            finishedTyping = false;
+            showPage(currentPageIndex + 1);
             charTimer = 0.f;
-            if (font) bodyText.setString( utf8_to_wstring(string("")) );
             //Iniciar blip de nuevo para la nueva pagina
             voiceBlip.playLoop();
         } else {
@@ -283,19 +238,19 @@ void DialogueBox::update(float dt) {
         voiceBlip.stop();
         return;
     }
-    const string& page = pages[currentPageIndex];
     charTimer += dt;
-    while (charTimer >= charInterval && !finishedTyping) {
-        charTimer -= charInterval;
-        if (charIndexInPage < page.size()) {
-            currentShownText.push_back(page[charIndexInPage]);
-            charIndexInPage++;
-            if (font) bodyText.setString( utf8_to_wstring(currentShownText) );
-        } else {
-            finishedTyping = true;
-            //Detener blip si se completo
-            voiceBlip.stop();
-        }
+    if (charTimer < charInterval){return;}
+    //Todos los caracteres que tocan en este frame de una vez: solo cambia cuantos vertices se dibujan
+    size_t steps = static_cast<size_t>(charTimer / charInterval);
+    charTimer -= steps * charInterval;
+    size_t remaining = pages[currentPageIndex].length() - charIndexInPage;
+    if (steps <= remaining) {
+        charIndexInPage += steps;
+    } else {
+        charIndexInPage = pages[currentPageIndex].length();
+        finishedTyping = true;
+        //Detener blip si se completo
+        voiceBlip.stop();
     }
 }
 
@@ -306,9 +261,22 @@ void DialogueBox::draw(RenderWindow& window) {
 	} else{
 		window.draw(fallbackBackground);
 	}
-    if (font) {
+    if (glyphAtlas) {
+        //Hint, speaker y lo escrito de la pagina: un solo draw contra el atlas
+        size_t from = finishedTyping ? 0 : hintVertices;
+        size_t to = chrome.vertices.size();
+        if (currentPageIndex < pages.size() && charIndexInPage > 0) {
+            to += pages[currentPageIndex].vertexEnd[charIndexInPage - 1];
+        }
+        if (to > from) {
+            window.draw(textLayer.vertices.data() + from, to - from, Triangles, RenderStates(&glyphAtlas->getTexture()));
+        }
+    } else if (font) {
         window.draw(speakerText);
-        window.draw(bodyText);
+        if (currentPageIndex < pages.size() && charIndexInPage > 0) {
+            const GlyphRun& page = pages[currentPageIndex];
+            window.draw(page.vertices.data(), page.vertexEnd[charIndexInPage - 1], Triangles, RenderStates(&font->getTexture(bodyText.getCharacterSize())));
+        }
         if (finishedTyping){
         	window.draw(hintText);
 		}
@@ -5,7 +5,9 @@
 #include <string>
 #include <vector>
 #include "../core/ResourceManager.h"
+#include "../audio/VoiceBank.h"
 #include "VoiceBlip.h"
+#include "../graphics/TextLayout.h"
 using namespace std;
 using namespace sf;
 
@@ -13,11 +15,11 @@ class DialogueBox {
 public:
 	//Constructor importante
     DialogueBox(ResourceManager& res,
-                const string& fontPath,
+                ResourceId font,
                 const Vector2f& size,
                 const Vector2f& position,
-                const string& bgTexturePath = "",
-                const string& voicePath = "assets/audio/voice_blip.wav");
+                ResourceId bgTexture = ResourceId(),
+                VoiceBank* voices = nullptr);
     //Set a un nuevo dialogo
     void setDialogue(const string& speaker, const string& text);
     //Avanza si esta escribiendo
@@ -37,6 +39,10 @@ public:
 private:
     ResourceManager& resources;
     Font* font;
+    //Hash del contenido del ttf: parte de la clave de LayoutCache
+    uint64_t fontHash;
+    //Si la fuente tiene atlas: todo el texto de la caja sale en un draw (si no, Text + paginas de la Font)
+    const GlyphAtlas* glyphAtlas;
     //Background
     Sprite backgroundSprite;
     RectangleShape fallbackBackground;
@@ -46,25 +52,35 @@ private:
     Vector2f boxPosition;
     //Textos visibles
     Text speakerText;
+    //Solo guarda estilo y posicion del cuerpo: se dibuja con los quads de la pagina
     Text bodyText;
     Text hintText;
     //Typewriter + paginado
     string fullText;
-    string currentShownText;
     float charTimer;
     float charInterval;
+    //Codepoints ya visibles de la pagina actual
     size_t charIndexInPage;
     bool finishedTyping;
     bool active;
     //Paginacion
-    vector<string> pages;
+    //Cada pagina decodificada una vez, con los quads de sus glifos
+    vector<GlyphRun> pages;
     size_t currentPageIndex;
-    //Voice blip mientras haya typewriting activo
+    //Con atlas: [hint][speaker][pagina actual] en un solo arreglo; chrome = hint + speaker
+    GlyphRun chrome;
+    GlyphRun textLayer;
+    size_t hintVertices;
+    //Voice blip mientras haya typewriting activo (voz segun el speaker)
+    VoiceBank* voices;
+    //Antes que voiceBlip: el buffer vive hasta que el stream se detiene
+    SoundHandle voiceBuffer;
     VoiceBlip voiceBlip;
-    string voiceFilePath;
     //Helpers
     void buildPages();
-    float measureWidthUtf8(const string& utf8) const;
+    void addPage(const string& text);
+    void buildChrome(const string& speaker);
+    void showPage(size_t index);
     static wstring utf8_to_wstring(const string& str);
 };
 
@@ -1,17 +1,24 @@
 #include "Scene.h"
 #include "../save/SaveManager.h"
-#include <fstream>
+#include "SceneLoader.h"
 #include <iostream>
 #include <algorithm>
-#include <iterator>
+
+namespace {
+const ResourceId DialogueFont = ResourceId::of("assets/fonts/default.ttf");
+const ResourceId DialogueBoxTexture = ResourceId::of("assets/images/ui/dialogue_box.png");
+}
 
 Scene::Scene() : 
     resources(nullptr), 
+    audio(nullptr), 
     currentIndex(0), 
     characterAnimator(nullptr), 
     hasCharacter(false), 
     characterVisible(true), 
     characterPosition(800.f, 400.f), 
+    characterFps(8), 
+    textureGeneration(0), 
     waitingChoice(false), 
     finished(false), 
     onMusicChange(nullptr), 
@@ -27,295 +34,224 @@ void Scene::setMusicChangeCallback(MusicChangeCallback callback){
     onMusicChange = callback;
 }
 
-string Scene::dirname(const string& path){
-    size_t p = path.find_last_of("/\\");
-    if (p == string::npos){
-    	return ".";	
-	}
-    return path.substr(0, p);
+void Scene::setAudioSystem(AudioSystem* a){
+    audio = a;
 }
 
-bool Scene::pathLooksLikeAssets(const string& p){
-    if (p.size() < 7){
-    	return false;
-	}
-    string start = p.substr(0, 7);
-    for (auto& c : start){
-    	c = tolower(c);
-	}
-    return start == "assets/";
+bool Scene::loadFromFile(const string& path, ResourceManager& res, int startIndex){
+    //.scnb compilado si existe, si no el .json
+    auto data = make_shared<SceneData>();
+    if (!SceneLoader::load(path, *data)){
+        return false;
+    }
+    return load(data, path, res, startIndex);
 }
 
-bool Scene::loadFromFile(const string& path, ResourceManager& res, int startIndex){
+bool Scene::load(shared_ptr<const SceneData> data, const string& path, ResourceManager& res, int startIndex){
+    if (!data){return false;}
     resources = &res;
     scenePath = path;
+    sceneData = data;
     characterVisible = true;
-    ifstream f(path, ios::binary);
-    if (!f.is_open()){
-        cout << "[System] No se pudo abrir " << path << endl;
-        return false;
-    }
-    string content((istreambuf_iterator<char>(f)), istreambuf_iterator<char>());
-    f.close();
-    json j = json::parse(content);
-    basePath = dirname(path);
+    basePath = sceneDirOf(path);
     
-    steps.clear();
     currentIndex = startIndex;
     waitingChoice = false;
+    availableChoices.clear();
     finished = false;
     nextScene.clear();
-    if (j.contains("bg")){
-        string bg = j["bg"];
-        string full = pathLooksLikeAssets(bg) ? bg : basePath + "/" + bg;
-        bgSprite.setTexture(resources->getTexture(full));
+    const SceneHeader& header = sceneData->header;
+    //Rutas de assets normalizadas y hasheadas una sola vez: los steps solo indexan
+    assetIds.assign(sceneData->strings.size(), ResourceId());
+    auto addAsset = [&](StrId id){
+        if (id && !assetIds[id]){
+            assetIds[id] = ResourceId::of(resolveAssetPath(basePath, str(id)));
+        }
+    };
+    for (const auto& s : sceneData->steps){
+        if (s.op == StepOp::ChangeBg){
+            addAsset(s.changeBg.bg);
+        }else if (s.op == StepOp::PlaySfx){
+            addAsset(s.playSfx.sfx);
+        }else if (s.op == StepOp::Dialogue){
+            addAsset(s.dialogue.sfx);
+        }
+    }
+    //Los assets se piden async: el primer frame puede salir sin fondo si no estaban precargados
+    pendingBg = TextureHandle();
+    if (!header.bg.empty()){
+        showBackground(resources->loadTextureAsync(ResourceId::of(resolveAssetPath(basePath, header.bg))));
     }
     hasCharacter = false;
     characterAnimator.reset();
-    if (j.contains("character")){
-        auto c = j["character"];
-        string f1 = c.value("frame1", "");
-        string f2 = c.value("frame2", "");
-        int fps = c.value("fps", 8);
-        float x = c.value("x", characterPosition.x);
-        float y = c.value("y", characterPosition.y);
-        characterPosition = { x, y };
-        if (!f1.empty() && !f2.empty()){
-            string p1 = pathLooksLikeAssets(f1) ? f1 : basePath + "/" + f1;
-            string p2 = pathLooksLikeAssets(f2) ? f2 : basePath + "/" + f2;
-            try{
-                Texture& t1 = resources->getTexture(p1);
-                Texture& t2 = resources->getTexture(p2);
-                
-                characterSprite.setTexture(t1);
-                auto s = t1.getSize();
-                characterSprite.setOrigin(s.x / 2.f, s.y / 2.f);
-                characterSprite.setPosition(characterPosition);
-                
-                characterAnimator = make_unique<SpriteAnimator>();
-                characterAnimator->attachSprite(&characterSprite);
-                characterAnimator->loadFrames(&t1, &t2);
-                characterAnimator->setFPS(fps);
-                characterAnimator->play();
-                hasCharacter = true;
-            }
-            catch (...){
-                hasCharacter = false;
-            }
-        }
-    }
-    json arr = j.contains("steps") ? j["steps"] : j["sequence"];
-    for (auto& item : arr){
-        SceneStep s;
-        s.type = item.value("type", "dialogue");
-        if (s.type == "goto") {
-		    if (item.contains("scene")) {
-		        s.goto_scene = item["scene"].get<string>();
-		    } else if (item.contains("goto")) {
-		        s.goto_scene = item["goto"].get<string>();
-		    } else {
-		        s.goto_scene = "";
-		    }
-		}
-        if (s.type == "dialogue") {
-            s.speaker = item.value("speaker", "");
-            s.text = item.value("text", "");
-            if (item.contains("sfx")){
-                s.sfx_path = item.value("sfx", "");
-                s.sfx_volume = item.value("sfx_volume", 100.0f);
-            }
-        } else if (s.type == "change_bg") {
-            s.bg_path = item.value("bg", "");
-            if (item.contains("music"))
-            {
-                s.music_path = item.value("music", "");
-            }
-        } else if (s.type == "goto") {
-		    s.goto_scene = item.value("scene", "");
-		    if (s.goto_scene.empty()) {
-		        cerr << "[System] ERROR: goto sin 'scene'" << endl;
-		    }
-		} else if (s.type == "choice") {
-            if (!item.contains("choices") || !item["choices"].is_array()){
-                cerr << "[System] ERROR: 'choice' step debe tener array 'choices'" << endl;
-                continue;
-            }
-            for (auto& c : item["choices"]){
-                SceneStep::Choice ch;
-                //Texto de la opcion
-                ch.text = c.value("text", "");
-                //Cambiar a otra escena
-                if (c.contains("goto")){
-                    ch.goto_scene = c["goto"].get<string>();
-                } else if (c.contains("next")){
-                    ch.goto_scene = c["next"].get<string>();
-                }else{
-                    ch.goto_scene = "";
-                }
-                //Saltar a un step especifico en esta escena
-                if (c.contains("goto_step")){
-                    try{
-                        ch.goto_step = c["goto_step"].get<int>();
-                    }catch (...){
-                        ch.goto_step = -1;
-                    }
-                }else{
-                    ch.goto_step = -1;
-                }
-                //Flag a guardar cuando se elige
-                if (c.contains("flag")){
-                    ch.flag = c["flag"].get<string>();
-                }else{
-                    ch.flag = "";
-                }
-                //Flag necesario para que aparezca
-                if (c.contains("require_flag")){
-                    ch.require_flag = c["require_flag"].get<string>();
-                }else{
-                    ch.require_flag = "";
-                }
-                s.choices.push_back(ch);
-                if (!ch.goto_scene.empty()){
-                    cout << " -> escena: " << ch.goto_scene;
-                }else if (ch.goto_step >= 0){
-                    cout << " -> step: " << ch.goto_step;
-                }
-                if (!ch.flag.empty()){
-                    cout << " (flag: " << ch.flag << ")";
-                }
-                if (!ch.require_flag.empty()){
-                    cout << " (requiere: " << ch.require_flag << ")";
-                }
-                cout << endl;
-            }
-        } else if (s.type == "play_sfx"){
-            s.sfx_path = item.value("sound", "");
-            if (s.sfx_path.empty()){
-                s.sfx_path = item.value("sfx", "");
+    characterFrame1 = TextureHandle();
+    characterFrame2 = TextureHandle();
+    pendingFrame1 = TextureHandle();
+    pendingFrame2 = TextureHandle();
+    if (header.hasCharacter){
+        const SceneCharacter& c = header.character;
+        characterPosition = { c.x, c.y };
+        characterFps = c.fps;
+        if (!c.frame1.empty() && !c.frame2.empty()){
+            ResourceId frame1 = ResourceId::of(resolveAssetPath(basePath, c.frame1));
+            ResourceId frame2 = ResourceId::of(resolveAssetPath(basePath, c.frame2));
+            //Empaquetados en el atlas: ya estan en la GPU y animar es solo cambiar el rect
+            AtlasRegion r1 = resources->findRegion(frame1);
+            AtlasRegion r2 = resources->findRegion(frame2);
+            if (r1 && r2){
+                setupCharacter(r1, r2);
+            }else{
+                pendingFrame1 = resources->loadTextureAsync(frame1);
+                pendingFrame2 = resources->loadTextureAsync(frame2);
+                applyPendingResources();
             }
-            s.sfx_volume = item.value("volume", 100.0f);
-        } else if (s.type == "transition"){
-            s.effect = item.value("effect", "fade");
-            s.duration = item.value("duration", 1.0f);
         }
-        steps.push_back(s);
     }
     dialogue = make_unique<DialogueBox>(
         *resources,
-        "assets/fonts/default.ttf",
+        DialogueFont,
         Vector2f(1700.f, 260.f),
         Vector2f(110.f, 780.f),
-        "assets/images/ui/dialogue_box.png"
+        DialogueBoxTexture,
+        audio ? &audio->getVoiceBank() : nullptr
     );
     
     currentIndex = startIndex;
-    if (currentIndex < steps.size()){
-    	startStep(steps[currentIndex]);
+    if (currentIndex < sceneData->steps.size()){
+    	startStep(sceneData->steps[currentIndex]);
 	}else{
 		finished = true;
 	}
     return true;
 }
 
+//Tabla de ejecucion, en el mismo orden que StepOp
+const Scene::StepHandler Scene::stepHandlers[] = {
+#define SCENE_STEP_HANDLER_PTR(op, name) &Scene::run##op,
+    SCENE_STEP_OPS(SCENE_STEP_HANDLER_PTR)
+#undef SCENE_STEP_HANDLER_PTR
+};
+
+string_view Scene::str(StrId id) const{
+    return sceneData->strings.get(id);
+}
+
+ResourceId Scene::assetId(StrId id) const{
+    return id < assetIds.size() ? assetIds[id] : ResourceId();
+}
+
 void Scene::startStep(const SceneStep& s){
-    //Limpiar sonidos terminados
-    cleanupFinishedSounds();
-    if (s.type == "hide_character"){
-        characterVisible = false;
-        advanceStep();
-        return;
+    (this->*stepHandlers[static_cast<size_t>(s.op)])(s);
+}
+
+void Scene::runUnknown(const SceneStep&){
+    //Tipo no soportado: se queda esperando input como antes
+}
+
+void Scene::runHideCharacter(const SceneStep&){
+    characterVisible = false;
+    advanceStep();
+}
+
+void Scene::runShowCharacter(const SceneStep&){
+    characterVisible = true;
+    advanceStep();
+}
+
+void Scene::runCheckpoint(const SceneStep&){
+    string id = scenePath.substr(scenePath.find_last_of("/\\") + 1);
+    id = id.substr(0, id.find(".json"));
+    SaveManager::getInstance().save(id, currentIndex);
+    advanceStep();
+}
+
+void Scene::runGoto(const SceneStep& s){
+    if (!s.gotoScene.scene) {
+        cerr << "[Scene] goto sin escena válida" << endl;
     }
-    if (s.type == "show_character"){
-        characterVisible = true;
-        advanceStep();
-        return;
+    nextScene = str(s.gotoScene.scene);
+    finished = true;
+}
+
+void Scene::runDialogue(const SceneStep& s){
+    dialogue->setDialogue(string(str(s.dialogue.speaker)), string(str(s.dialogue.text)));
+    if (s.dialogue.sfx){
+        playSFX(assetId(s.dialogue.sfx), s.dialogue.sfxVolume);
     }
-    if (s.type == "checkpoint"){
-        string id = scenePath.substr(scenePath.find_last_of("/\\") + 1);
-        id = id.substr(0, id.find(".json"));
-        SaveManager::getInstance().save(id, currentIndex);
-        advanceStep();
-        return;
+}
+
+void Scene::runChangeBg(const SceneStep& s){
+    //El fondo anterior sigue hasta que el nuevo este en la GPU
+    showBackground(resources->loadTextureAsync(assetId(s.changeBg.bg)));
+    if (s.changeBg.music && onMusicChange){
+        onMusicChange(string(str(s.changeBg.music)));
     }
-    if (s.type == "goto"){
-	    if (s.goto_scene.empty()) {
-	        cerr << "[Scene] goto sin escena válida" << endl;
-	        nextScene = s.goto_scene;
-	        finished = true;
-	        return;
-	    }
-	    nextScene = s.goto_scene;
-	    finished = true;
-	    return;
-	}
-    
-    if (s.type == "dialogue"){
-        dialogue->setDialogue(s.speaker, s.text);
-        if (!s.sfx_path.empty()){
-            playSFX(s.sfx_path, s.sfx_volume);
-        }
-    }else if (s.type == "change_bg"){
-        string full = pathLooksLikeAssets(s.bg_path) ? s.bg_path : basePath + "/" + s.bg_path;
-        bgSprite.setTexture(resources->getTexture(full));
-        if (!s.music_path.empty() && onMusicChange){
-            onMusicChange(s.music_path);
-        }
-        advanceStep();
-    }else if (s.type == "play_sfx"){
-        if (!s.sfx_path.empty()){
-            playSFX(s.sfx_path, s.sfx_volume);
-        }
+    advanceStep();
+}
+
+void Scene::runPlaySfx(const SceneStep& s){
+    if (s.playSfx.sfx){
+        playSFX(assetId(s.playSfx.sfx), s.playSfx.volume);
+    }
+    advanceStep();
+}
+
+void Scene::runTransition(const SceneStep& s){
+    switch (s.transition.effect){
+    case TransitionEffect::FadeToBlack:
+        transition.start(TransitionManager::Type::FADE_TO_BLACK, s.transition.duration);
+        waitingTransition = true;
+        break;
+    case TransitionEffect::FadeFromBlack:
+        transition.start(TransitionManager::Type::FADE_FROM_BLACK, s.transition.duration);
+        waitingTransition = true;
+        break;
+    default:
+        cout << "[System] Efecto de transición desconocido: " << str(s.transition.effectName) << endl;
         advanceStep();
-    }else if (s.type == "transition"){
-        if (s.effect == "fade" || s.effect == "fade_to_black"){
-            transition.start(TransitionManager::Type::FADE_TO_BLACK, s.duration);
-            waitingTransition = true;
-        }else if (s.effect == "fade_from_black"){
-            transition.start(TransitionManager::Type::FADE_FROM_BLACK, s.duration);
-            waitingTransition = true;
-        }else{
-            cout << "[System] Efecto de transición desconocido: " << s.effect << endl;
-            advanceStep();
-        }
-    }else if (s.type == "choice"){
-        waitingChoice = true;
-        //Filtrar choices segun flags
-        vector<SceneStep::Choice> availableChoices;
-        for (const auto& choice : s.choices){
-            //Si pide flag, verificar si existe
-            if (!choice.require_flag.empty()){
-                if (!SaveManager::getInstance().hasFlag(choice.require_flag)){
-                    cout << "[System] Choice '" << choice.text << "' oculta (falta flag: " << choice.require_flag << ")" << endl;
-                    continue;
-                }
+        break;
+    }
+}
+
+void Scene::runChoice(const SceneStep& s){
+    waitingChoice = true;
+    //Filtrar choices segun flags
+    availableChoices.clear();
+    for (uint32_t i = s.choice.first; i < s.choice.first + s.choice.count; ++i){
+        const auto& choice = sceneData->choices[i];
+        //Si pide flag, verificar si existe
+        if (choice.require_flag){
+            if (!SaveManager::getInstance().hasFlag(string(str(choice.require_flag)))){
+                cout << "[System] Choice '" << str(choice.text) << "' oculta (falta flag: " << str(choice.require_flag) << ")" << endl;
+                continue;
             }
-            availableChoices.push_back(choice);
-        }
-        //Verificar que haya  una opcion disponible
-        if (availableChoices.empty()){
-            cerr << "[System] ERROR: Todas las choices están bloqueadas por flags" << endl;
-            //Avanzar al siguiente step
-            waitingChoice = false;
-            advanceStep();
-            return;
         }
-        //Construir texto con choices disponibles
-        string text;
-        for (size_t i = 0; i < availableChoices.size(); ++i){
-            text += to_string(i + 1) + ". " + availableChoices[i].text + "\n";
-        }
-        //Guardar temporalmente las choices
-        steps[currentIndex].choices = availableChoices;
-        dialogue->setDialogue("Elige", text);
+        availableChoices.push_back(i);
+    }
+    //Verificar que haya  una opcion disponible
+    if (availableChoices.empty()){
+        cerr << "[System] ERROR: Todas las choices están bloqueadas por flags" << endl;
+        //Avanzar al siguiente step
+        waitingChoice = false;
+        advanceStep();
+        return;
+    }
+    //Construir texto con choices disponibles
+    string text;
+    for (size_t i = 0; i < availableChoices.size(); ++i){
+        text += to_string(i + 1) + ". ";
+        text += str(sceneData->choices[availableChoices[i]].text);
+        text += "\n";
     }
+    dialogue->setDialogue("Elige", text);
 }
 
 void Scene::advanceStep(){
     if (finished){
     	return;
 	}
-    if (++currentIndex < steps.size()){
-    	startStep(steps[currentIndex]);
+    if (++currentIndex < sceneData->steps.size()){
+    	startStep(sceneData->steps[currentIndex]);
 	}else{
 		finished = true;
 	} 
@@ -323,13 +259,7 @@ void Scene::advanceStep(){
 
 void Scene::update(float dt){
 	if (finished){return;}
-    //Limpiar sonidos
-    static float cleanupTimer = 0.0f;
-    cleanupTimer += dt;
-    if (cleanupTimer >= 0.5f){
-        cleanupFinishedSounds();
-        cleanupTimer = 0.0f;
-    }
+    applyPendingResources();
     //Actualizar transicion activa
     if (waitingTransition){
         transition.update(dt);
@@ -368,23 +298,23 @@ void Scene::handleEvent(const Event& ev){
                 choiceIndex = ev.key.code - Keyboard::Numpad1;
             }
             //Validar que la opcion existe
-            if (choiceIndex >= 0 && choiceIndex < (int)steps[currentIndex].choices.size()){
-                const auto& chosen = steps[currentIndex].choices[choiceIndex];
+            if (choiceIndex >= 0 && choiceIndex < (int)availableChoices.size()){
+                const auto& chosen = sceneData->choices[availableChoices[choiceIndex]];
                 //Guardar flag si esta definido
-                if (!chosen.flag.empty()){
-                    SaveManager::getInstance().setFlag(chosen.flag, true);
-                    cout << "[System] Flag guardado: " << chosen.flag << endl;
+                if (chosen.flag){
+                    SaveManager::getInstance().setFlag(string(str(chosen.flag)), true);
+                    cout << "[System] Flag guardado: " << str(chosen.flag) << endl;
                 }
                 //Decidir si cambiar de escena o hacer branching interno
-                if (!chosen.goto_scene.empty()){
-                    nextScene = chosen.goto_scene;
+                if (chosen.goto_scene){
+                    nextScene = str(chosen.goto_scene);
                     waitingChoice = false;
                     finished = true;
                 }else if (chosen.goto_step >= 0){
                     currentIndex = chosen.goto_step;
                     waitingChoice = false;
-                    if (currentIndex < steps.size()){
-                        startStep(steps[currentIndex]);
+                    if (currentIndex < sceneData->steps.size()){
+                        startStep(sceneData->steps[currentIndex]);
                     }else{
                         cerr << "[System] ERROR: goto_step fuera de rango: " << chosen.goto_step << endl;
                         finished = true;
@@ -393,9 +323,9 @@ void Scene::handleEvent(const Event& ev){
                     waitingChoice = false;
                     advanceStep();
                 }
-            }else if (choiceIndex >= (int)steps[currentIndex].choices.size()){
+            }else if (choiceIndex >= (int)availableChoices.size()){
                 // Tecla numerica valida pero fuera de rango
-                cout << "[System] La opción " << (choiceIndex + 1) << " no existe. Opciones disponibles: 1-" << steps[currentIndex].choices.size() << endl;
+                cout << "[System] La opción " << (choiceIndex + 1) << " no existe. Opciones disponibles: 1-" << availableChoices.size() << endl;
             }
         }
         return;
@@ -430,31 +360,58 @@ string Scene::getNextScene() const{
     return nextScene;
 }
 
-void Scene::playSFX(const string& path, float volume){
-    if (!resources){return;	}
-    try{
-        string fullPath = pathLooksLikeAssets(path)
-            ? path
-            : basePath + "/" + path;
-        sf::SoundBuffer& buffer = resources->getSound(fullPath);
-        auto sound = std::make_unique<sf::Sound>();
-        sound->setBuffer(buffer);
-        sound->setVolume(volume);
-        sound->play();
-        activeSounds.push_back(std::move(sound));
-    }
-    catch (const std::exception& e){
-        cerr << "[System] SFX: " << e.what() << endl;
+void Scene::playSFX(ResourceId sfx, float volume){
+    //Voces del pool compartido: sin reservas por disparo
+    if (!audio || !sfx){return;	}
+    audio->playSound(sfx, volume);
+}
+
+void Scene::showBackground(const TextureHandle& handle){
+    if (handle.ready()){
+        bgSprite.setTexture(handle.get(), true);
+        //Variante reducida (tier): se estira a su tamaño original
+        bgSprite.setScale(handle.scale(), handle.scale());
+        bgTexture = handle;
+        pendingBg = TextureHandle();
+    }else if (!handle.failed()){
+        pendingBg = handle;
     }
 }
 
-void Scene::cleanupFinishedSounds(){
-    auto it = activeSounds.begin();
-    while (it != activeSounds.end()){
-        if ((*it)->getStatus() == sf::Sound::Stopped){
-        	it = activeSounds.erase(it);
-		}else{
-			++it;
-		} 
+void Scene::applyPendingResources(){
+    if (pendingBg.valid()){
+        showBackground(pendingBg);
     }
+    //Cambio de tier: el fondo se recargo en la misma textura con otro tamaño
+    if (resources && textureGeneration != resources->getTextureGeneration()){
+        textureGeneration = resources->getTextureGeneration();
+        if (bgTexture.ready()){
+            bgSprite.setTexture(bgTexture.get(), true);
+            bgSprite.setScale(bgTexture.scale(), bgTexture.scale());
+        }
+    }
+    if (pendingFrame1.valid() && pendingFrame2.valid()){
+        if (pendingFrame1.failed() || pendingFrame2.failed()){
+            pendingFrame1 = TextureHandle();
+            pendingFrame2 = TextureHandle();
+        }else if (pendingFrame1.ready() && pendingFrame2.ready()){
+            setupCharacter(wholeTexture(pendingFrame1.get()), wholeTexture(pendingFrame2.get()));
+            characterFrame1 = move(pendingFrame1);
+            characterFrame2 = move(pendingFrame2);
+            pendingFrame1 = TextureHandle();
+            pendingFrame2 = TextureHandle();
+        }
+    }
+}
+
+void Scene::setupCharacter(const AtlasRegion& frame1, const AtlasRegion& frame2){
+    applyRegion(characterSprite, frame1);
+    characterSprite.setOrigin(frame1.rect.width / 2.f, frame1.rect.height / 2.f);
+    characterSprite.setPosition(characterPosition);
+    characterAnimator = make_unique<SpriteAnimator>();
+    characterAnimator->attachSprite(&characterSprite);
+    characterAnimator->loadFrames(frame1, frame2);
+    characterAnimator->setFPS(characterFps);
+    characterAnimator->play();
+    hasCharacter = true;
 }
@@ -3,49 +3,32 @@
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
-#include "json.hpp"
 #include <string>
 #include <vector>
 #include <memory>
 #include <functional>
 #include "../core/ResourceManager.h"
+#include "../audio/AudioSystem.h"
 #include "DialogueBox.h"
 #include "../graphics/SpriteAnimator.hpp"
 #include "../graphics/TransitionManager.h"
 #include "../save/SaveManager.h"
+#include "SceneData.h"
 using namespace std;
 using namespace sf;
-using json = nlohmann::json;
 
 typedef function<void(const string&)> MusicChangeCallback;
 
-struct SceneStep {
-    string type;
-    string speaker;
-    string text;
-    string bg_path;
-    string music_path;
-    string sfx_path;
-    float sfx_volume;
-    string effect;
-    float duration;
-    string goto_scene;
-    struct Choice { 
-        string text;
-        string goto_scene;
-        int goto_step = -1;
-        string flag;
-        string require_flag;
-    };
-    vector<Choice> choices;
-};
-
 class Scene {
 public:
     Scene();
     bool loadFromFile(const string& path, ResourceManager& res, int startIndex=0);
+    //Usa una escena ya parseada (compartida con SceneCache)
+    bool load(shared_ptr<const SceneData> data, const string& path, ResourceManager& res, int startIndex=0);
     
     void setMusicChangeCallback(MusicChangeCallback callback);
+    //Los sfx van al pool de voces compartido (llamar antes de load)
+    void setAudioSystem(AudioSystem* audio);
     void setScreenSize(Vector2u size);
 
     void update(float dt);
@@ -57,7 +40,8 @@ public:
 
 private:
     ResourceManager* resources;
-    vector<SceneStep> steps;
+    AudioSystem* audio;
+    shared_ptr<const SceneData> sceneData;
     size_t currentIndex;
     //Background
     Sprite bgSprite;
@@ -65,12 +49,24 @@ private:
     Sprite characterSprite;
     unique_ptr<SpriteAnimator> characterAnimator;
     Vector2f characterPosition;
+    int characterFps;
     bool characterVisible;    
     bool hasCharacter;
+    //Lo que se esta mostrando: el handle evita que el LRU lo libere
+    TextureHandle bgTexture;
+    TextureHandle characterFrame1;
+    TextureHandle characterFrame2;
+    //Texturas pedidas async que todavia no estan listas (se aplican en update)
+    TextureHandle pendingBg;
+    TextureHandle pendingFrame1;
+    TextureHandle pendingFrame2;
+    //ResourceManager::getTextureGeneration con la que se armo bgSprite
+    unsigned textureGeneration;
     //Dialogo
     unique_ptr<DialogueBox> dialogue;
     //Control
     bool waitingChoice;
+    vector<uint32_t> availableChoices;
     bool finished;
     string nextScene;
     string basePath;
@@ -78,19 +74,27 @@ private:
     int nextStartIndex;
     //Llamar a musica
     MusicChangeCallback onMusicChange;
-    //Sfx
-	vector<std::unique_ptr<sf::Sound>> activeSounds;
     //Sistema de transiciones
     TransitionManager transition;
     bool waitingTransition;
+    //Ejecucion de steps: un handler por opcode (ver SCENE_STEP_OPS)
+    typedef void (Scene::*StepHandler)(const SceneStep& s);
+    static const StepHandler stepHandlers[];
+#define SCENE_STEP_HANDLER(op, name) void run##op(const SceneStep& s);
+    SCENE_STEP_OPS(SCENE_STEP_HANDLER)
+#undef SCENE_STEP_HANDLER
+    string_view str(StrId id) const;
+    //Id de cada ruta de asset de la escena, indexado por StrId (se arma en load)
+    vector<ResourceId> assetIds;
+    ResourceId assetId(StrId id) const;
     //Helpers
     void startStep(const SceneStep& s);
     void advanceStep();
-    string dirname(const string& path);
     //Play musica
-    void playSFX(const string& path, float volume = 100.f);
-    void cleanupFinishedSounds();
-    static bool pathLooksLikeAssets(const string& p);
+    void playSFX(ResourceId sfx, float volume = 100.f);
+    void showBackground(const TextureHandle& handle);
+    void applyPendingResources();
+    void setupCharacter(const AtlasRegion& frame1, const AtlasRegion& frame2);
 };
 
 #endif
\ No newline at end of file
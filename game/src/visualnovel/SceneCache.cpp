@@ -0,0 +1,96 @@
+#include "SceneCache.h"
+#include "SceneLoader.h"
+#include <algorithm>
+namespace fs = std::filesystem;
+
+SceneCache::SceneCache(size_t cap)
+: capacity(max<size_t>(1, cap)),
+  hitCount(0),
+  missCount(0)
+{
+}
+
+string SceneCache::normalize(const string& path) {
+    string key = path;
+    replace(key.begin(), key.end(), '\\', '/');
+    return key;
+}
+
+fs::file_time_type SceneCache::stampOf(const string& path) {
+    //Cambia si se edita el .json o se recompila el .scnb
+    error_code ec;
+    fs::file_time_type stamp = fs::file_time_type::min();
+    auto jsonTime = fs::last_write_time(path, ec);
+    if (!ec){stamp = jsonTime;}
+    auto binTime = fs::last_write_time(SceneLoader::binaryPathFor(path), ec);
+    if (!ec && binTime > stamp){stamp = binTime;}
+    return stamp;
+}
+
+shared_ptr<const SceneData> SceneCache::get(const string& path) {
+    string key = normalize(path);
+    fs::file_time_type stamp = stampOf(key);
+    {
+        lock_guard<mutex> lock(cacheMutex);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            if (it->second->stamp == stamp) {
+                entries.splice(entries.begin(), entries, it->second);
+                hitCount++;
+                return it->second->data;
+            }
+            //El archivo cambio en disco
+            entries.erase(it->second);
+            index.erase(it);
+        }
+        missCount++;
+    }
+    //El parse va sin lock para no frenar al otro hilo
+    auto data = make_shared<SceneData>();
+    if (!SceneLoader::load(key, *data)) {
+        return nullptr;
+    }
+    lock_guard<mutex> lock(cacheMutex);
+    auto it = index.find(key);
+    if (it != index.end() && it->second->stamp == stamp) {
+        //Otro hilo la cargo mientras tanto
+        return it->second->data;
+    }
+    if (it != index.end()) {
+        entries.erase(it->second);
+        index.erase(it);
+    }
+    entries.push_front(Entry{ key, stamp, data });
+    index[key] = entries.begin();
+    trim();
+    return data;
+}
+
+void SceneCache::setCapacity(size_t cap) {
+    lock_guard<mutex> lock(cacheMutex);
+    capacity = max<size_t>(1, cap);
+    trim();
+}
+
+void SceneCache::clear() {
+    lock_guard<mutex> lock(cacheMutex);
+    entries.clear();
+    index.clear();
+}
+
+size_t SceneCache::hits() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return hitCount;
+}
+
+size_t SceneCache::misses() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return missCount;
+}
+
+void SceneCache::trim() {
+    while (entries.size() > capacity) {
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef SCENE_CACHE_H
+#define SCENE_CACHE_H
+
+#include <string>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <filesystem>
+#include <mutex>
+#include "SceneData.h"
+using namespace std;
+
+//LRU de escenas ya parseadas, por path + fecha de modificacion
+//Scene y SceneManager comparten la misma SceneData (un solo read/parse)
+//Se puede usar desde el hilo de precarga (ScenePrefetcher)
+class SceneCache {
+public:
+    explicit SceneCache(size_t capacity = 8);
+    //Devuelve la escena parseada o nullptr si no se pudo cargar
+    shared_ptr<const SceneData> get(const string& path);
+    void setCapacity(size_t capacity);
+    void clear();
+    size_t hits() const;
+    size_t misses() const;
+private:
+    struct Entry {
+        string key;
+        filesystem::file_time_type stamp;
+        shared_ptr<const SceneData> data;
+    };
+    mutable mutex cacheMutex;
+    size_t capacity;
+    list<Entry> entries; //El mas reciente al frente
+    unordered_map<string, list<Entry>::iterator> index;
+    size_t hitCount;
+    size_t missCount;
+    static string normalize(const string& path);
+    static filesystem::file_time_type stampOf(const string& path);
+    void trim();
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include "SceneData.h"
+#include <cctype>
+
+namespace {
+const char* const stepOpNames[] = {
+#define SCENE_STEP_NAME(op, name) name,
+    SCENE_STEP_OPS(SCENE_STEP_NAME)
+#undef SCENE_STEP_NAME
+};
+}
+
+string sceneDirOf(const string& scenePath) {
+    size_t p = scenePath.find_last_of("/\\");
+    if (p == string::npos){
+    	return ".";
+	}
+    return scenePath.substr(0, p);
+}
+
+SceneData::SceneData()
+: steps(&arena),
+  choices(&arena),
+  strings(&arena)
+{
+}
+
+void SceneData::clear() {
+    header = SceneHeader();
+    //Primero se sueltan los contenedores, despues se libera el arena
+    pmr::vector<SceneStep>(&arena).swap(steps);
+    pmr::vector<SceneStep::Choice>(&arena).swap(choices);
+    strings.clear();
+    arena.reset();
+}
+
+string resolveAssetPath(const string& sceneDir, string_view asset) {
+    //Los paths que empiezan con "assets/" son relativos a la carpeta del juego
+    if (asset.size() >= 7){
+        string start(asset.substr(0, 7));
+        for (auto& c : start){
+            c = tolower(c);
+        }
+        if (start == "assets/"){return string(asset);}
+    }
+    string full = sceneDir;
+    full += '/';
+    full += asset;
+    return full;
+}
+
+string resolveScenePath(string_view target) {
+    if (target.find('/') == string_view::npos && target.find('\\') == string_view::npos) {
+        string full = "data/scenes/";
+        full += target;
+        return full;
+    }
+    return string(target);
+}
+
+StepOp stepOpFromName(string_view name) {
+    //Solo se usa al cargar, nunca al ejecutar
+    for (size_t i = 1; i < static_cast<size_t>(StepOp::Count); ++i) {
+        if (name == stepOpNames[i]){return static_cast<StepOp>(i);}
+    }
+    return StepOp::Unknown;
+}
+
+const char* stepOpName(StepOp op) {
+    if (op >= StepOp::Count){return "";}
+    return stepOpNames[static_cast<size_t>(op)];
+}
+
+TransitionEffect transitionEffectFromName(string_view name) {
+    if (name == "fade" || name == "fade_to_black"){return TransitionEffect::FadeToBlack;}
+    if (name == "fade_from_black"){return TransitionEffect::FadeFromBlack;}
+    return TransitionEffect::Unknown;
+}
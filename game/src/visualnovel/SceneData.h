@@ -0,0 +1,145 @@
+#ifndef SCENE_DATA_H
+#define SCENE_DATA_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory_resource>
+#include <cstdint>
+#include "../core/Arena.h"
+#include "../core/StringPool.h"
+using namespace std;
+
+//Tipos de step: opcode + nombre en el JSON
+//Para un tipo nuevo: agregarlo aqui, darle su struct de operandos en SceneStep, leerlo en SceneLoader y escribir Scene::runX
+#define SCENE_STEP_OPS(X) \
+    X(Unknown,       "") \
+    X(Dialogue,      "dialogue") \
+    X(ChangeBg,      "change_bg") \
+    X(PlaySfx,       "play_sfx") \
+    X(Transition,    "transition") \
+    X(Choice,        "choice") \
+    X(Goto,          "goto") \
+    X(Checkpoint,    "checkpoint") \
+    X(ShowCharacter, "show_character") \
+    X(HideCharacter, "hide_character")
+
+enum class StepOp : uint8_t {
+#define SCENE_STEP_ENUM(op, name) op,
+    SCENE_STEP_OPS(SCENE_STEP_ENUM)
+#undef SCENE_STEP_ENUM
+    Count
+};
+
+enum class TransitionEffect : uint8_t {
+    Unknown,
+    FadeToBlack,
+    FadeFromBlack
+};
+
+//Rutas: assets relativos a la carpeta de la escena y destinos de goto
+string sceneDirOf(const string& scenePath);
+string resolveAssetPath(const string& sceneDir, string_view asset);
+string resolveScenePath(string_view target);
+
+StepOp stepOpFromName(string_view name);
+const char* stepOpName(StepOp op);
+TransitionEffect transitionEffectFromName(string_view name);
+
+//Operandos de cada tipo de step (ids en el pool de strings de la escena)
+struct DialogueStep {
+    StrId speaker;
+    StrId text;
+    StrId sfx;
+    float sfxVolume;
+};
+
+struct ChangeBgStep {
+    StrId bg;
+    StrId music;
+};
+
+struct PlaySfxStep {
+    StrId sfx;
+    float volume;
+};
+
+struct TransitionStep {
+    TransitionEffect effect;
+    StrId effectName;
+    float duration;
+};
+
+//Rango dentro de SceneData::choices
+struct ChoiceStep {
+    uint32_t first;
+    uint32_t count;
+};
+
+struct GotoStep {
+    StrId scene;
+};
+
+//Step ya compilado: opcode + los operandos de su tipo en el mismo lugar (union)
+//Solo se lee el miembro que corresponde a op; checkpoint y show/hide_character no tienen operandos
+struct SceneStep {
+    StepOp op;
+    union {
+        DialogueStep dialogue;
+        ChangeBgStep changeBg;
+        PlaySfxStep playSfx;
+        TransitionStep transition;
+        ChoiceStep choice;
+        GotoStep gotoScene;
+        uint32_t raw[4];
+    };
+    SceneStep() : op(StepOp::Unknown), raw{} {}
+    struct Choice {
+        StrId text = 0;
+        StrId goto_scene = 0;
+        StrId flag = 0;
+        StrId require_flag = 0;
+        int32_t goto_step = -1;
+    };
+};
+static_assert(sizeof(DialogueStep) <= sizeof(SceneStep::raw) && sizeof(TransitionStep) <= sizeof(SceneStep::raw),
+              "los operandos de un step tienen que entrar en raw");
+
+//Los string_view de la cabecera apuntan a la NameTable o al arena de la escena
+struct SceneCharacter {
+    string_view frame1;
+    string_view frame2;
+    int fps = 8;
+    float x = 800.f;
+    float y = 400.f;
+};
+
+//Campos de cabecera del JSON de la escena
+struct SceneHeader {
+    string_view bg;
+    string_view music;
+    bool hasMusic = false;
+    float musicVolume = 70.f;
+    bool hasCharacter = false;
+    SceneCharacter character;
+};
+
+//Datos de una escena ya parseados (sin SFML, lo usan tambien las tools)
+//Steps, choices y textos salen del arena de la escena: se liberan todos juntos
+//No se copia ni se mueve (los contenedores apuntan a su arena)
+struct SceneData {
+    SceneData();
+    SceneData(const SceneData&) = delete;
+    SceneData& operator=(const SceneData&) = delete;
+    Arena arena;
+    SceneHeader header;
+    //Programa de la escena
+    pmr::vector<SceneStep> steps;
+    pmr::vector<SceneStep::Choice> choices;
+    StringPool strings;
+    string_view str(StrId id) const { return strings.get(id); }
+    //Vacia la escena y devuelve el arena completo de una vez
+    void clear();
+};
+
+#endif
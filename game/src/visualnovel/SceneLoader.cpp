@@ -0,0 +1,668 @@
+#include "SceneLoader.h"
+#include "../core/MappedFile.h"
+#include "../core/AssetPack.h"
+#include "json.hpp"
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <filesystem>
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace {
+//Layout del .scnb (little endian, todo alineado a 4 bytes)
+//Los campos de texto son ids del pool: la tabla guarda los strings en orden de id, terminados en '\0'
+struct SceneFileHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    uint32_t stepCount;
+    uint32_t choiceCount;
+    uint32_t stringCount;
+    uint32_t stringTableSize;
+    uint32_t stepsOffset;
+    uint32_t choicesOffset;
+    uint32_t stringsOffset;
+    uint32_t bg;
+    uint32_t music;
+    float musicVolume;
+    uint32_t charFrame1;
+    uint32_t charFrame2;
+    int32_t charFps;
+    float charX;
+    float charY;
+};
+
+//Mismo layout que SceneStep: opcode + los 16 bytes de operandos de su tipo
+struct SceneStepRecord {
+    uint8_t op;
+    uint8_t reserved[3];
+    uint32_t payload[4];
+};
+
+struct SceneChoiceRecord {
+    uint32_t text;
+    uint32_t gotoScene;
+    uint32_t flag;
+    uint32_t requireFlag;
+    int32_t gotoStep;
+};
+
+const char SceneMagic[4] = { 'R', 'S', 'C', 'N' };
+const uint16_t FlagHasMusic = 1;
+const uint16_t FlagHasCharacter = 2;
+
+uint32_t align4(uint32_t v) {
+    return (v + 3u) & ~3u;
+}
+
+//Recorre los ids de texto de un step segun su tipo; isName = speaker, rutas, efectos y destinos
+template <typename Fn>
+void visitStepStrings(SceneStep& s, Fn fn) {
+    switch (s.op) {
+    case StepOp::Dialogue:
+        fn(s.dialogue.speaker, true);
+        fn(s.dialogue.text, false);
+        fn(s.dialogue.sfx, true);
+        break;
+    case StepOp::ChangeBg:
+        fn(s.changeBg.bg, true);
+        fn(s.changeBg.music, true);
+        break;
+    case StepOp::PlaySfx:
+        fn(s.playSfx.sfx, true);
+        break;
+    case StepOp::Transition:
+        fn(s.transition.effectName, true);
+        break;
+    case StepOp::Goto:
+        fn(s.gotoScene.scene, true);
+        break;
+    default:
+        break;
+    }
+}
+
+}
+
+string SceneLoader::binaryPathFor(const string& jsonPath) {
+    size_t dot = jsonPath.find_last_of('.');
+    size_t slash = jsonPath.find_last_of("/\\");
+    if (dot == string::npos || (slash != string::npos && dot < slash)) {
+        return jsonPath + ".scnb";
+    }
+    return jsonPath.substr(0, dot) + ".scnb";
+}
+
+bool SceneLoader::load(const string& jsonPath, SceneData& out) {
+    string binPath = binaryPathFor(jsonPath);
+    //Empaquetada y sin ninguno de los dos sueltos: se lee directo del mapeo del pack
+    //(un .json suelto editado tiene que ganarle al .scnb empaquetado, no solo a su .json)
+    const AssetPack& pack = AssetPack::getInstance();
+    ResourceId jsonId = ResourceId::of(jsonPath);
+    ResourceId binId = ResourceId::of(binPath);
+    if (!pack.isOverridden(jsonId) && !pack.isOverridden(binId)) {
+        const char* packed = nullptr;
+        size_t packedSize = 0;
+        if (pack.find(binId, packed, packedSize) && parseBinary(packed, packedSize, binPath, out)) {
+            return true;
+        }
+        if (pack.find(jsonId, packed, packedSize)) {
+            return parseJson(packed, packed + packedSize, out);
+        }
+    }
+    error_code ec;
+    if (fs::exists(binPath, ec)) {
+        //En desarrollo el .json editado gana sobre un .scnb viejo
+        bool stale = false;
+        if (fs::exists(jsonPath, ec)) {
+            auto jsonTime = fs::last_write_time(jsonPath, ec);
+            auto binTime = fs::last_write_time(binPath, ec);
+            stale = !ec && jsonTime > binTime;
+        }
+        if (stale) {
+            cout << "[System] " << binPath << " desactualizado, usando JSON" << endl;
+        } else if (loadBinary(binPath, out)) {
+            return true;
+        }
+    }
+    return loadJson(jsonPath, out);
+}
+
+namespace {
+//Campos crudos de una choice mientras llegan los tokens
+//reset() vacia sin soltar la capacidad: despues de los primeros steps ya no se reserva memoria
+struct RawChoice {
+    string text;
+    string gotoScene;
+    string next;
+    int gotoStep;
+    string flag;
+    string requireFlag;
+    void reset() {
+        text.clear();
+        gotoScene.clear();
+        next.clear();
+        gotoStep = -1;
+        flag.clear();
+        requireFlag.clear();
+    }
+};
+
+//Campos crudos de un step: solo vive uno a la vez
+struct RawStep {
+    string type;
+    string speaker;
+    string text;
+    string bg;
+    string music;
+    bool hasMusic;
+    string sfx;
+    bool hasSfx;
+    string sound;
+    float sfxVolume;
+    float volume;
+    string effect;
+    float duration;
+    string scene;
+    string gotoScene;
+    bool hasChoices;
+    vector<RawChoice> choices;
+    size_t choiceCount;
+    void reset() {
+        type.assign("dialogue");
+        speaker.clear();
+        text.clear();
+        bg.clear();
+        music.clear();
+        hasMusic = false;
+        sfx.clear();
+        hasSfx = false;
+        sound.clear();
+        sfxVolume = 100.f;
+        volume = 100.f;
+        effect.assign("fade");
+        duration = 1.f;
+        scene.clear();
+        gotoScene.clear();
+        hasChoices = false;
+        choiceCount = 0;
+    }
+    RawChoice& addChoice() {
+        if (choiceCount == choices.size()) {
+            choices.emplace_back();
+        }
+        RawChoice& c = choices[choiceCount++];
+        c.reset();
+        return c;
+    }
+};
+
+//Parser SAX: arma SceneStep directo desde los tokens, sin DOM intermedio
+class SceneSaxHandler : public nlohmann::json_sax<json> {
+public:
+    explicit SceneSaxHandler(SceneData& data) : out(data), choice(nullptr), stepsFromSequence(false) {
+        contexts.reserve(8);
+    }
+    std::string errorMessage;
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+    bool number_integer(number_integer_t val) override { return number(static_cast<double>(val)); }
+    bool number_unsigned(number_unsigned_t val) override { return number(static_cast<double>(val)); }
+    bool number_float(number_float_t val, const string_t&) override { return number(val); }
+    bool binary(binary_t&) override { return true; }
+
+    bool string(string_t& val) override {
+        switch (context()) {
+        case Context::Root:
+            if (currentKey == "bg"){out.header.bg = NameTable::getInstance().intern(val);}
+            else if (currentKey == "music"){out.header.hasMusic = true; out.header.music = NameTable::getInstance().intern(val);}
+            break;
+        case Context::Character:
+            if (currentKey == "frame1"){out.header.character.frame1 = NameTable::getInstance().intern(val);}
+            else if (currentKey == "frame2"){out.header.character.frame2 = NameTable::getInstance().intern(val);}
+            break;
+        case Context::Step:
+            if (currentKey == "type"){step.type.assign(val);}
+            else if (currentKey == "speaker"){step.speaker.assign(val);}
+            else if (currentKey == "text"){step.text.assign(val);}
+            else if (currentKey == "bg"){step.bg.assign(val);}
+            else if (currentKey == "music"){step.hasMusic = true; step.music.assign(val);}
+            else if (currentKey == "sfx"){step.hasSfx = true; step.sfx.assign(val);}
+            else if (currentKey == "sound"){step.sound.assign(val);}
+            else if (currentKey == "effect"){step.effect.assign(val);}
+            else if (currentKey == "scene"){step.scene.assign(val);}
+            else if (currentKey == "goto"){step.gotoScene.assign(val);}
+            break;
+        case Context::Choice:
+            if (currentKey == "text"){choice->text.assign(val);}
+            else if (currentKey == "goto"){choice->gotoScene.assign(val);}
+            else if (currentKey == "next"){choice->next.assign(val);}
+            else if (currentKey == "flag"){choice->flag.assign(val);}
+            else if (currentKey == "require_flag"){choice->requireFlag.assign(val);}
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        currentKey.assign(val);
+        return true;
+    }
+
+    bool start_object(size_t) override {
+        Context parent = contexts.empty() ? Context::None : context();
+        Context next = Context::Skip;
+        if (parent == Context::None) {
+            next = Context::Root;
+        } else if (parent == Context::Root && currentKey == "character") {
+            out.header.hasCharacter = true;
+            next = Context::Character;
+        } else if (parent == Context::Steps) {
+            step.reset();
+            next = Context::Step;
+        } else if (parent == Context::Choices) {
+            choice = &step.addChoice();
+            next = Context::Choice;
+        }
+        contexts.push_back(next);
+        return true;
+    }
+
+    bool end_object() override {
+        Context ended = context();
+        contexts.pop_back();
+        if (ended == Context::Step) {
+            emitStep();
+        }
+        return true;
+    }
+
+    bool start_array(size_t) override {
+        Context parent = contexts.empty() ? Context::None : context();
+        Context next = Context::Skip;
+        if (parent == Context::Root && (currentKey == "steps" || currentKey == "sequence")) {
+            //"steps" tiene prioridad sobre "sequence"
+            if (currentKey == "sequence" && !out.steps.empty() && !stepsFromSequence) {
+                next = Context::Skip;
+            } else {
+                if (currentKey == "steps" && stepsFromSequence) {
+                    //Lo ya leido queda en el arena hasta el proximo reset
+                    out.steps.clear();
+                    out.choices.clear();
+                    out.strings.clear();
+                }
+                stepsFromSequence = (currentKey == "sequence");
+                next = Context::Steps;
+            }
+        } else if (parent == Context::Step && currentKey == "choices") {
+            step.hasChoices = true;
+            next = Context::Choices;
+        }
+        contexts.push_back(next);
+        return true;
+    }
+
+    bool end_array() override {
+        contexts.pop_back();
+        return true;
+    }
+
+    bool parse_error(size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+        errorMessage = ex.what();
+        return false;
+    }
+
+private:
+    enum class Context { None, Root, Character, Steps, Step, Choices, Choice, Skip };
+    SceneData& out;
+    vector<Context> contexts;
+    std::string currentKey;
+    RawStep step;
+    RawChoice* choice;
+    bool stepsFromSequence;
+
+    Context context() const {
+        return contexts.back();
+    }
+
+    bool number(double val) {
+        float f = static_cast<float>(val);
+        switch (context()) {
+        case Context::Root:
+            if (currentKey == "music_volume"){out.header.musicVolume = f;}
+            break;
+        case Context::Character:
+            if (currentKey == "fps"){out.header.character.fps = static_cast<int>(val);}
+            else if (currentKey == "x"){out.header.character.x = f;}
+            else if (currentKey == "y"){out.header.character.y = f;}
+            break;
+        case Context::Step:
+            if (currentKey == "sfx_volume"){step.sfxVolume = f;}
+            else if (currentKey == "volume"){step.volume = f;}
+            else if (currentKey == "duration"){step.duration = f;}
+            break;
+        case Context::Choice:
+            if (currentKey == "goto_step"){choice->gotoStep = static_cast<int>(val);}
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
+
+    //Baja el step crudo a opcode + ids y lo agrega a la escena
+    void emitStep() {
+        //Speaker, rutas, flags y destinos van a la NameTable; los textos al arena de la escena
+        StringPool& pool = out.strings;
+        SceneStep s;
+        //El tipo se resuelve a opcode una sola vez, aqui
+        s.op = stepOpFromName(step.type);
+        switch (s.op) {
+        case StepOp::Dialogue:
+            s.dialogue.speaker = pool.internName(step.speaker);
+            s.dialogue.text = pool.intern(step.text);
+            s.dialogue.sfx = step.hasSfx ? pool.internName(step.sfx) : 0;
+            s.dialogue.sfxVolume = step.hasSfx ? step.sfxVolume : 100.f;
+            break;
+        case StepOp::ChangeBg:
+            s.changeBg.bg = pool.internName(step.bg);
+            s.changeBg.music = step.hasMusic ? pool.internName(step.music) : 0;
+            break;
+        case StepOp::Goto: {
+            const std::string& target = !step.scene.empty() ? step.scene : step.gotoScene;
+            if (target.empty()) {
+                cerr << "[System] ERROR: goto sin 'scene'" << endl;
+            }
+            s.gotoScene.scene = pool.internName(target);
+            break;
+        }
+        case StepOp::Choice:
+            if (!step.hasChoices){
+                cerr << "[System] ERROR: 'choice' step debe tener array 'choices'" << endl;
+                return;
+            }
+            s.choice.first = static_cast<uint32_t>(out.choices.size());
+            for (size_t i = 0; i < step.choiceCount; ++i){
+                const RawChoice& c = step.choices[i];
+                SceneStep::Choice ch;
+                ch.text = pool.intern(c.text);
+                //Cambiar a otra escena, si no saltar a un step de esta
+                ch.goto_scene = pool.internName(!c.gotoScene.empty() ? c.gotoScene : c.next);
+                ch.goto_step = c.gotoStep;
+                ch.flag = pool.internName(c.flag);
+                ch.require_flag = pool.internName(c.requireFlag);
+                out.choices.push_back(ch);
+            }
+            s.choice.count = static_cast<uint32_t>(step.choiceCount);
+            break;
+        case StepOp::PlaySfx:
+            s.playSfx.sfx = pool.internName(!step.sound.empty() ? step.sound : step.sfx);
+            s.playSfx.volume = step.volume;
+            break;
+        case StepOp::Transition:
+            s.transition.effectName = pool.internName(step.effect);
+            s.transition.effect = transitionEffectFromName(step.effect);
+            s.transition.duration = step.duration;
+            break;
+        case StepOp::Unknown:
+            cout << "[System] Tipo de step desconocido: " << step.type << endl;
+            break;
+        default:
+            break;
+        }
+        out.steps.push_back(s);
+    }
+};
+}
+
+bool SceneLoader::loadJson(const string& path, SceneData& out) {
+    //El JSON se lee directo del mapeo, sin copiarlo a un string
+    MappedFile file;
+    if (!file.open(path)){
+        cout << "[System] No se pudo abrir " << path << endl;
+        return false;
+    }
+    return parseJson(file.data(), file.data() + file.size(), out);
+}
+
+bool SceneLoader::parseJson(const string& content, SceneData& out) {
+    return parseJson(content.data(), content.data() + content.size(), out);
+}
+
+bool SceneLoader::parseJson(const char* begin, const char* end, SceneData& out) {
+    out.clear();
+    //Textos, vistas, steps y el crecimiento de los vectores rondan 2-3 veces el JSON: asi alcanza un bloque
+    out.arena.reserve(static_cast<size_t>(end - begin) * 3);
+    SceneSaxHandler handler(out);
+    bool ok = false;
+    try {
+        ok = json::sax_parse(begin, end, &handler);
+    } catch (const exception& e) {
+        handler.errorMessage = e.what();
+    }
+    if (!ok) {
+        cerr << "[System] ERROR: JSON de escena invalido: " << handler.errorMessage << endl;
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+bool SceneLoader::loadBinary(const string& path, SceneData& out) {
+    MappedFile file;
+    if (!file.open(path)){
+        cerr << "[System] No se pudo mapear " << path << endl;
+        return false;
+    }
+    return parseBinary(file.data(), file.size(), path, out);
+}
+
+bool SceneLoader::parseBinary(const char* base, size_t size, const string& path, SceneData& out) {
+    if (size < sizeof(SceneFileHeader)){
+        cerr << "[System] ERROR: " << path << " truncado" << endl;
+        return false;
+    }
+    SceneFileHeader h;
+    memcpy(&h, base, sizeof(h));
+    if (memcmp(h.magic, SceneMagic, 4) != 0 || h.version != BinaryVersion){
+        cerr << "[System] " << path << " no es un .scnb v" << BinaryVersion << ", se ignora" << endl;
+        return false;
+    }
+    uint64_t stepsEnd = uint64_t(h.stepsOffset) + uint64_t(h.stepCount) * sizeof(SceneStepRecord);
+    uint64_t choicesEnd = uint64_t(h.choicesOffset) + uint64_t(h.choiceCount) * sizeof(SceneChoiceRecord);
+    uint64_t stringsEnd = uint64_t(h.stringsOffset) + h.stringTableSize;
+    if (stepsEnd > size || choicesEnd > size || stringsEnd > size || h.stringTableSize == 0
+        || base[h.stringsOffset + h.stringTableSize - 1] != '\0'){
+        cerr << "[System] ERROR: " << path << " corrupto" << endl;
+        return false;
+    }
+    out.clear();
+    out.arena.reserve(h.stringTableSize + h.stringCount * 3 * sizeof(string_view)
+                      + h.stepCount * sizeof(SceneStep) + h.choiceCount * sizeof(SceneStep::Choice));
+    const SceneStepRecord* stepRecords = reinterpret_cast<const SceneStepRecord*>(base + h.stepsOffset);
+    const SceneChoiceRecord* choiceRecords = reinterpret_cast<const SceneChoiceRecord*>(base + h.choicesOffset);
+    //Los operandos se copian tal cual; los ids se validan cuando ya esta el pool
+    bool badRef = false;
+    out.steps.resize(h.stepCount);
+    for (uint32_t i = 0; i < h.stepCount && !badRef; ++i){
+        const SceneStepRecord& r = stepRecords[i];
+        SceneStep& s = out.steps[i];
+        if (r.op >= static_cast<uint8_t>(StepOp::Count)){
+            badRef = true;
+            break;
+        }
+        s.op = static_cast<StepOp>(r.op);
+        memcpy(s.raw, r.payload, sizeof(s.raw));
+        if (s.op == StepOp::Choice && uint64_t(s.choice.first) + s.choice.count > h.choiceCount){
+            badRef = true;
+        }
+        if (s.op == StepOp::Transition && s.transition.effect > TransitionEffect::FadeFromBlack){
+            s.transition.effect = TransitionEffect::Unknown;
+        }
+    }
+    out.choices.resize(h.choiceCount);
+    for (uint32_t c = 0; c < h.choiceCount; ++c){
+        const SceneChoiceRecord& cr = choiceRecords[c];
+        SceneStep::Choice& ch = out.choices[c];
+        ch.text = cr.text;
+        ch.goto_scene = cr.gotoScene;
+        ch.flag = cr.flag;
+        ch.require_flag = cr.requireFlag;
+        ch.goto_step = cr.gotoStep;
+    }
+    //Que ids son nombres (speaker, rutas, flags) para mandarlos a la NameTable
+    vector<bool> isName(h.stringCount, false);
+    auto markName = [&](uint32_t id) {
+        if (id < h.stringCount){isName[id] = true;}
+    };
+    markName(h.bg);
+    markName(h.music);
+    markName(h.charFrame1);
+    markName(h.charFrame2);
+    if (!badRef){
+        for (auto& s : out.steps){
+            visitStepStrings(s, [&](StrId& id, bool name) {
+                if (name){markName(id);}
+            });
+        }
+    }
+    for (const auto& ch : out.choices){
+        markName(ch.goto_scene);
+        markName(ch.flag);
+        markName(ch.require_flag);
+    }
+    //Pool: los strings ya vienen sin repetir y en orden de id
+    const char* cursor = base + h.stringsOffset;
+    const char* tableEnd = cursor + h.stringTableSize;
+    for (uint32_t id = 0; id < h.stringCount && !badRef; ++id){
+        if (cursor >= tableEnd){
+            cerr << "[System] ERROR: " << path << " tabla de strings incompleta" << endl;
+            out.clear();
+            return false;
+        }
+        string_view s(cursor);
+        cursor += s.size() + 1;
+        StrId got = isName[id] ? out.strings.internName(s) : out.strings.intern(s);
+        if (got != id){
+            cerr << "[System] ERROR: " << path << " tabla de strings corrupta" << endl;
+            out.clear();
+            return false;
+        }
+    }
+    uint32_t stringCount = static_cast<uint32_t>(out.strings.size());
+    auto ref = [&](uint32_t id) -> StrId {
+        if (id >= stringCount){
+            badRef = true;
+            return 0;
+        }
+        return id;
+    };
+    auto str = [&](uint32_t id) -> string_view {
+        return out.strings.get(ref(id));
+    };
+    out.header.bg = str(h.bg);
+    out.header.hasMusic = (h.flags & FlagHasMusic) != 0;
+    out.header.music = str(h.music);
+    out.header.musicVolume = h.musicVolume;
+    out.header.hasCharacter = (h.flags & FlagHasCharacter) != 0;
+    out.header.character.frame1 = str(h.charFrame1);
+    out.header.character.frame2 = str(h.charFrame2);
+    out.header.character.fps = h.charFps;
+    out.header.character.x = h.charX;
+    out.header.character.y = h.charY;
+    for (auto& s : out.steps){
+        visitStepStrings(s, [&](StrId& id, bool) {
+            id = ref(id);
+        });
+    }
+    for (auto& ch : out.choices){
+        ch.text = ref(ch.text);
+        ch.goto_scene = ref(ch.goto_scene);
+        ch.flag = ref(ch.flag);
+        ch.require_flag = ref(ch.require_flag);
+    }
+    if (badRef){
+        cerr << "[System] ERROR: " << path << " tiene referencias fuera de rango" << endl;
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+bool SceneLoader::writeBinary(const string& path, const SceneData& data) {
+    //La cabecera usa strings sueltos: se internan en una copia del pool (mismos ids)
+    Arena scratch;
+    StringPool strings(&scratch);
+    for (size_t id = 1; id < data.strings.size(); ++id){
+        strings.intern(data.strings.get(static_cast<StrId>(id)));
+    }
+    SceneFileHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SceneMagic, 4);
+    h.version = BinaryVersion;
+    h.flags = (data.header.hasMusic ? FlagHasMusic : 0) | (data.header.hasCharacter ? FlagHasCharacter : 0);
+    h.bg = strings.intern(data.header.bg);
+    h.music = strings.intern(data.header.music);
+    h.musicVolume = data.header.musicVolume;
+    h.charFrame1 = strings.intern(data.header.character.frame1);
+    h.charFrame2 = strings.intern(data.header.character.frame2);
+    h.charFps = data.header.character.fps;
+    h.charX = data.header.character.x;
+    h.charY = data.header.character.y;
+
+    vector<SceneStepRecord> stepRecords;
+    stepRecords.reserve(data.steps.size());
+    for (const auto& s : data.steps){
+        SceneStepRecord r;
+        memset(&r, 0, sizeof(r));
+        r.op = static_cast<uint8_t>(s.op);
+        memcpy(r.payload, s.raw, sizeof(r.payload));
+        stepRecords.push_back(r);
+    }
+    vector<SceneChoiceRecord> choiceRecords;
+    choiceRecords.reserve(data.choices.size());
+    for (const auto& ch : data.choices){
+        SceneChoiceRecord cr;
+        cr.text = ch.text;
+        cr.gotoScene = ch.goto_scene;
+        cr.flag = ch.flag;
+        cr.requireFlag = ch.require_flag;
+        cr.gotoStep = ch.goto_step;
+        choiceRecords.push_back(cr);
+    }
+    vector<char> table;
+    for (size_t id = 0; id < strings.size(); ++id){
+        string_view s = strings.get(static_cast<StrId>(id));
+        table.insert(table.end(), s.begin(), s.end());
+        table.push_back('\0');
+    }
+    h.stepCount = static_cast<uint32_t>(stepRecords.size());
+    h.choiceCount = static_cast<uint32_t>(choiceRecords.size());
+    h.stringCount = static_cast<uint32_t>(strings.size());
+    h.stringTableSize = static_cast<uint32_t>(table.size());
+    h.stepsOffset = align4(sizeof(SceneFileHeader));
+    h.choicesOffset = align4(h.stepsOffset + h.stepCount * sizeof(SceneStepRecord));
+    h.stringsOffset = align4(h.choicesOffset + h.choiceCount * sizeof(SceneChoiceRecord));
+
+    vector<char> blob(h.stringsOffset + h.stringTableSize, '\0');
+    memcpy(blob.data(), &h, sizeof(h));
+    if (!stepRecords.empty()){
+        memcpy(blob.data() + h.stepsOffset, stepRecords.data(), stepRecords.size() * sizeof(SceneStepRecord));
+    }
+    if (!choiceRecords.empty()){
+        memcpy(blob.data() + h.choicesOffset, choiceRecords.data(), choiceRecords.size() * sizeof(SceneChoiceRecord));
+    }
+    memcpy(blob.data() + h.stringsOffset, table.data(), h.stringTableSize);
+
+    ofstream f(path, ios::binary | ios::trunc);
+    if (!f.is_open()){
+        cerr << "[System] No se pudo escribir " << path << endl;
+        return false;
+    }
+    f.write(blob.data(), blob.size());
+    return f.good();
+}
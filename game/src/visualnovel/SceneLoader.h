@@ -0,0 +1,29 @@
+#ifndef SCENE_LOADER_H
+#define SCENE_LOADER_H
+
+#include <string>
+#include <cstdint>
+#include "SceneData.h"
+using namespace std;
+
+//Lectura de escenas desde .json (desarrollo) o .scnb compilado (builds)
+class SceneLoader {
+public:
+    //Version del formato binario, subirla al cambiar los records
+    static const uint16_t BinaryVersion = 3;
+    //Los sueltos (.json o .scnb) ganan sobre el pack; suelto usa el .scnb si existe y no es mas viejo que el .json, si no parsea el .json
+    static bool load(const string& jsonPath, SceneData& out);
+    static bool loadJson(const string& path, SceneData& out);
+    static bool parseJson(const string& content, SceneData& out);
+    //Parser SAX: llena los steps a medida que llegan los tokens, sin DOM
+    static bool parseJson(const char* begin, const char* end, SceneData& out);
+    //Formato binario: cabecera + steps de tamaño fijo + choices + tabla de strings
+    static bool loadBinary(const string& path, SceneData& out);
+    //El .scnb ya en memoria (mapeo propio o del pack); name solo es para los mensajes
+    static bool parseBinary(const char* data, size_t size, const string& name, SceneData& out);
+    static bool writeBinary(const string& path, const SceneData& data);
+    //"data/scenes/x.json" -> "data/scenes/x.scnb"
+    static string binaryPathFor(const string& jsonPath);
+};
+
+#endif
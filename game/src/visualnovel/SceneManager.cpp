@@ -1,13 +1,13 @@
 #include "SceneManager.h"
+#include "../core/AssetPack.h"
 #include <iostream>
-#include <fstream>
-#include "../json.hpp"
-using json = nlohmann::json;
 
-SceneManager::SceneManager(ResourceManager& res)
+SceneManager::SceneManager(ResourceManager& res, AudioSystem& audioSystem)
 : resources(res), 
+  audio(audioSystem), 
   currentScene(nullptr), 
-  currentMusicPath(""),
+  prefetcher(sceneCache, res),
+  musicVolume(70.f),
   screenSize(1920, 1080)
 {
 }
@@ -31,7 +31,10 @@ bool SceneManager::loadScene(const string& path, int startStep) {
     cout << "[System] Cargando escena: " << path << " (step " << startStep << ")" << endl;
     currentPath = path;
     currentScene = make_unique<Scene>();
-    bool success = currentScene->loadFromFile(path, resources, startStep);
+    currentScene->setAudioSystem(&audio);
+    //Un solo read/parse: la misma SceneData sirve para Scene y para la musica
+    shared_ptr<const SceneData> data = sceneCache.get(path);
+    bool success = data && currentScene->load(data, path, resources, startStep);
     if (!success) {
         cerr << "[System ERROR] No se pudo cargar: " << path << endl;
         currentScene.reset();
@@ -44,58 +47,29 @@ bool SceneManager::loadScene(const string& path, int startStep) {
     currentScene->setMusicChangeCallback([this](const string& musicPath) {
         this->loadMusic(musicPath);
     });
-    loadMusicFromJSON(path);
+    applySceneMusic(data->header);
+    //Mientras se lee esta escena, preparar las posibles siguientes
+    prefetcher.prefetchFrom(data, path);
     return true;
 }
 
-void SceneManager::loadMusicFromJSON(const string& scenePath) {
-    try {
-        ifstream file(scenePath);
-        if (!file.is_open()) {
-            cerr << "[System] No se pudo abrir JSON para leer música: " << scenePath << endl;
-            return;
-        }
-        json j;
-        file >> j;
-        file.close();
-        if (j.contains("music")) {
-            string musicPath = j["music"];
-            if (musicPath.empty()) {
-                stopMusic();
-                return;
-            }
-            loadMusic(musicPath);
-        } else {
-            stopMusic();
-        }
-    }
-    catch (const exception& e) {
-        cerr << "[System ERROR] Al leer música del JSON: " << e.what() << endl;
+void SceneManager::applySceneMusic(const SceneHeader& header) {
+    musicVolume = header.musicVolume;
+    if (!header.hasMusic || header.music.empty()) {
+        stopMusic();
+        return;
     }
+    loadMusic(string(header.music));
 }
 
 void SceneManager::loadMusic(const string& musicPath) {
-    if (musicPath == currentMusicPath && sceneMusic.getStatus() == Music::Playing) {
-        return;
-    }
-    stopMusic();
-    if (!sceneMusic.openFromFile(musicPath)) {
-        cerr << "[System ERROR] No se pudo cargar música: " << musicPath << endl;
-        return;
-    }
-    
-    currentMusicPath = musicPath;
-    sceneMusic.setLoop(true);
-    sceneMusic.setVolume(70.f);
-    sceneMusic.play();
-    cout << "[Music] ♪ Reproduciendo~: " << musicPath << endl;
+    //Se abre en el hilo de musica: la pista actual sigue sonando hasta el crossfade
+    //(si es la misma que ya suena solo se ajusta el volumen)
+    audio.getMusic().play(ResourceId::of(musicPath), musicVolume);
 }
 
 void SceneManager::stopMusic() {
-    if (sceneMusic.getStatus() == Music::Playing) {
-        sceneMusic.stop();
-    }
-    currentMusicPath.clear();
+    audio.getMusic().stop();
 }
 
 void SceneManager::update(float dt) {
@@ -108,11 +82,9 @@ void SceneManager::update(float dt) {
                 cerr << "[System WARNING] Escena intenta cargarse a sí misma: " << next << endl;
                 return;
             }
-            string fullPath = next;
-            if (next.find('/') == string::npos && next.find('\\') == string::npos) {
-                fullPath = "data/scenes/" + next;
-            }
-            loadScene(fullPath);
+            string nextPath = resolveScenePath(next);
+            prefetcher.consumePrediction(nextPath);
+            loadScene(nextPath);
         }
     }
 }
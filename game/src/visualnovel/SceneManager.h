@@ -6,13 +6,16 @@
 #include <string>
 #include <memory>
 #include "../core/ResourceManager.h"
+#include "../audio/AudioSystem.h"
 #include "Scene.h"
+#include "SceneCache.h"
+#include "ScenePrefetcher.h"
 using namespace std;
 using namespace sf;
 
 class SceneManager {
 public:
-    SceneManager(ResourceManager& res);
+    SceneManager(ResourceManager& res, AudioSystem& audio);
     ~SceneManager();
     //Carga la escena inicial
     bool loadInitialScene(const string& scenePath);
@@ -27,13 +30,17 @@ public:
     void setScreenSize(Vector2u size);
 private:
     ResourceManager& resources;
+    AudioSystem& audio;
     unique_ptr<Scene> currentScene;
     string currentPath;
-    //Sistema de musica
-    Music sceneMusic;
-    string currentMusicPath;
+    //Escenas parseadas, compartidas con Scene
+    SceneCache sceneCache;
+    //Precarga de las escenas siguientes mientras se lee
+    ScenePrefetcher prefetcher;
+    //Volumen de musica de la escena actual (music_volume del json)
+    float musicVolume;
     //Helpers
-    void loadMusicFromJSON(const string& scenePath);
+    void applySceneMusic(const SceneHeader& header);
     void loadMusic(const string& musicPath);
     void stopMusic();
     Vector2u screenSize;
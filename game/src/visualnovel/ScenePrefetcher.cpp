@@ -0,0 +1,173 @@
+#include "ScenePrefetcher.h"
+#include "../audio/SoundPolicy.h"
+#include <iostream>
+#include <algorithm>
+
+ScenePrefetcher::ScenePrefetcher(SceneCache& c, ResourceManager& res)
+: cache(c),
+  resources(res),
+  stopping(false),
+  round(0),
+  hitCount(0),
+  missCount(0)
+{
+    worker = thread(&ScenePrefetcher::run, this);
+}
+
+ScenePrefetcher::~ScenePrefetcher() {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+        pendingScenes.clear();
+        currentScene.reset();
+    }
+    wakeUp.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+string ScenePrefetcher::normalize(string_view path) {
+    string key = resolveScenePath(path);
+    replace(key.begin(), key.end(), '\\', '/');
+    return key;
+}
+
+void ScenePrefetcher::prefetchFrom(shared_ptr<const SceneData> scene, const string& scenePath) {
+    if (!scene){return;}
+    //Lo precargado para otras ramas ya no se va a usar, salvo lo de esta escena
+    vector<ResourceId> images;
+    vector<ResourceId> sounds;
+    string dir = sceneDirOf(scenePath);
+    collectAssets(*scene, dir, images, sounds);
+    set<ResourceId> keep(images.begin(), images.end());
+    keep.insert(sounds.begin(), sounds.end());
+    resources.discardPreloaded(keep);
+    string self = normalize(scenePath);
+    lock_guard<mutex> lock(queueMutex);
+    round++;
+    pendingScenes.clear();
+    predicted.clear();
+    warm.clear();
+    currentScene = scene;
+    currentDir = dir;
+    //Candidatos: goto y destinos de las choices
+    auto addCandidate = [&](StrId target) {
+        if (!target){return;}
+        string path = normalize(scene->str(target));
+        if (path == self || predicted.count(path)){return;}
+        predicted.insert(path);
+        pendingScenes.push_back(path);
+    };
+    for (const auto& step : scene->steps) {
+        if (step.op == StepOp::Goto) {
+            addCandidate(step.gotoScene.scene);
+        }
+    }
+    for (const auto& choice : scene->choices) {
+        addCandidate(choice.goto_scene);
+    }
+    wakeUp.notify_one();
+}
+
+bool ScenePrefetcher::consumePrediction(const string& scenePath) {
+    string path = normalize(scenePath);
+    lock_guard<mutex> lock(queueMutex);
+    bool hit = warm.count(path) > 0;
+    if (hit) {
+        hitCount++;
+    } else {
+        missCount++;
+    }
+    cout << "[Prefetch] " << (hit ? "Hit" : "Miss") << ": " << path
+         << " (" << hitCount << " hits / " << missCount << " misses)" << endl;
+    return hit;
+}
+
+size_t ScenePrefetcher::hits() const {
+    lock_guard<mutex> lock(queueMutex);
+    return hitCount;
+}
+
+size_t ScenePrefetcher::misses() const {
+    lock_guard<mutex> lock(queueMutex);
+    return missCount;
+}
+
+void ScenePrefetcher::run() {
+    while (true) {
+        shared_ptr<const SceneData> scene;
+        string sceneDir;
+        string nextPath;
+        size_t jobRound;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            wakeUp.wait(lock, [this] { return stopping || currentScene || !pendingScenes.empty(); });
+            if (stopping){return;}
+            jobRound = round;
+            if (currentScene) {
+                //Primero lo que la escena actual usa mas adelante (change_bg, sfx)
+                scene = currentScene;
+                sceneDir = currentDir;
+                currentScene.reset();
+            } else {
+                nextPath = pendingScenes.front();
+                pendingScenes.pop_front();
+            }
+        }
+        if (scene) {
+            warmAssets(*scene, sceneDir, jobRound);
+            continue;
+        }
+        shared_ptr<const SceneData> next = cache.get(nextPath);
+        if (!next){continue;}
+        bool complete = warmAssets(*next, sceneDirOf(nextPath), jobRound);
+        lock_guard<mutex> lock(queueMutex);
+        //Solo cuenta si termino dentro de la ronda actual
+        if (complete && jobRound == round) {
+            warm.insert(nextPath);
+        }
+    }
+}
+
+void ScenePrefetcher::collectAssets(const SceneData& scene, const string& sceneDir, vector<ResourceId>& images, vector<ResourceId>& sounds) {
+    const SceneHeader& header = scene.header;
+    if (!header.bg.empty()) {
+        images.push_back(ResourceId::of(resolveAssetPath(sceneDir, header.bg)));
+    }
+    if (header.hasCharacter && !header.character.frame1.empty() && !header.character.frame2.empty()) {
+        images.push_back(ResourceId::of(resolveAssetPath(sceneDir, header.character.frame1)));
+        images.push_back(ResourceId::of(resolveAssetPath(sceneDir, header.character.frame2)));
+    }
+    for (const auto& step : scene.steps) {
+        if (step.op == StepOp::ChangeBg && step.changeBg.bg) {
+            images.push_back(ResourceId::of(resolveAssetPath(sceneDir, scene.str(step.changeBg.bg))));
+        } else if (step.op == StepOp::PlaySfx && step.playSfx.sfx) {
+            sounds.push_back(ResourceId::of(resolveAssetPath(sceneDir, scene.str(step.playSfx.sfx))));
+        } else if (step.op == StepOp::Dialogue && step.dialogue.sfx) {
+            sounds.push_back(ResourceId::of(resolveAssetPath(sceneDir, scene.str(step.dialogue.sfx))));
+        }
+    }
+}
+
+bool ScenePrefetcher::warmAssets(const SceneData& scene, const string& sceneDir, size_t jobRound) {
+    vector<ResourceId> images;
+    vector<ResourceId> sounds;
+    collectAssets(scene, sceneDir, images, sounds);
+    auto cancelled = [&] {
+        //Cortar si ya empezo otra ronda
+        lock_guard<mutex> lock(queueMutex);
+        return stopping || jobRound != round;
+    };
+    for (ResourceId id : images) {
+        if (cancelled()){return false;}
+        resources.preloadImage(id);
+    }
+    for (ResourceId id : sounds) {
+        if (cancelled()){return false;}
+        //Los que van en stream no se decodifican nunca enteros
+        if (SoundPolicy::getInstance().shouldStream(id)){continue;}
+        resources.preloadSound(id);
+    }
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef SCENE_PREFETCHER_H
+#define SCENE_PREFETCHER_H
+
+#include <string>
+#include <deque>
+#include <set>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "../core/ResourceManager.h"
+#include "SceneCache.h"
+#include "SceneData.h"
+using namespace std;
+
+//Precarga en un hilo aparte las escenas a las que puede saltar la actual
+//(goto y choices) junto con sus fondos, personajes y sfx
+class ScenePrefetcher {
+public:
+    ScenePrefetcher(SceneCache& cache, ResourceManager& res);
+    ~ScenePrefetcher();
+    //Nueva ronda a partir de la escena que se acaba de cargar
+    void prefetchFrom(shared_ptr<const SceneData> scene, const string& scenePath);
+    //Al cambiar de escena: cuenta si la prediccion acerto
+    bool consumePrediction(const string& scenePath);
+    size_t hits() const;
+    size_t misses() const;
+private:
+    SceneCache& cache;
+    ResourceManager& resources;
+    thread worker;
+    mutable mutex queueMutex;
+    condition_variable wakeUp;
+    bool stopping;
+    size_t round;
+    //Trabajo pendiente de la ronda actual
+    shared_ptr<const SceneData> currentScene;
+    string currentDir;
+    deque<string> pendingScenes;
+    set<string> predicted;
+    set<string> warm;
+    size_t hitCount;
+    size_t missCount;
+    void run();
+    bool warmAssets(const SceneData& scene, const string& sceneDir, size_t jobRound);
+    static void collectAssets(const SceneData& scene, const string& sceneDir, vector<ResourceId>& images, vector<ResourceId>& sounds);
+    static string normalize(string_view path);
+};
+
+#endif
@@ -1,54 +1,103 @@
 #include "VoiceBlip.h"
-#include <iostream>
+#include <cmath>
+
+namespace {
+//Frames por chunk: ~23ms a 44.1kHz
+const size_t ChunkFrames = 1024;
+}
 
 VoiceBlip::VoiceBlip()
-: buffer(nullptr)
+: samples(nullptr),
+  frameCount(0),
+  channels(1),
+  position(0.0),
+  step(1.f),
+  timbre(0.f),
+  lowpass{0.f, 0.f}
 {
-    sound.setLoop(true); 
-    sound.setVolume(60.f);
+    SoundStream::setVolume(60.f);
 }
 
 VoiceBlip::~VoiceBlip() {
-    //Asegurar detener sonido antes de destruir buffer
-    try {
-        if (sound.getStatus() == Sound::Playing){
-        	sound.stop();
-		}
-    } catch (...) {}
-}
-
-bool VoiceBlip::loadFromFile(const string& path) {
-    buffer = make_unique<SoundBuffer>();
-    if (!buffer->loadFromFile(path)) {
-        cerr << "[System] No se pudo cargar audio: " << path << "\n";
-        buffer.reset();
-        return false;
+    //El hilo del stream lee nuestros campos: pararlo antes de destruirlos
+    SoundStream::stop();
+}
+
+void VoiceBlip::setVoice(const SoundBuffer* base, float pitch, float tone) {
+    const Int16* data = base ? base->getSamples() : nullptr;
+    if (data == samples && pitch == step && tone == timbre){return;}
+    bool wasPlaying = isPlaying();
+    SoundStream::stop();
+    samples = nullptr;
+    frameCount = 0;
+    step = pitch;
+    timbre = tone;
+    //Solo mono o estereo (lowpass guarda estado por canal)
+    if (data && base->getSampleCount() > 0 && base->getChannelCount() <= 2) {
+        channels = base->getChannelCount();
+        samples = data;
+        frameCount = size_t(base->getSampleCount()) / channels;
+        chunk.resize(ChunkFrames * channels);
+        initialize(channels, base->getSampleRate());
     }
-    sound.setBuffer(*buffer);
-    return true;
+    if (wasPlaying){playLoop();}
 }
 
 void VoiceBlip::playLoop() {
-    if (!buffer){return;}
-    if (sound.getStatus() != Sound::Playing) {
-        sound.setLoop(true);
-        sound.play();
+    if (!samples){return;}
+    if (getStatus() != SoundStream::Playing) {
+        play();
     }
 }
 
 void VoiceBlip::stop() {
-    if (sound.getStatus() == Sound::Playing) {
-        sound.stop();
-        try {
-            sound.setPlayingOffset(sf::Time::Zero);
-        } catch (...) {}
+    //stop() vuelve al inicio (onSeek con 0)
+    if (getStatus() == SoundStream::Playing) {
+        SoundStream::stop();
     }
 }
 
 void VoiceBlip::setVolume(float vol) {
-    sound.setVolume(vol);
+    SoundStream::setVolume(vol);
 }
 
 bool VoiceBlip::isPlaying() const {
-    return sound.getStatus() == Sound::Playing;
+    return getStatus() == SoundStream::Playing;
+}
+
+bool VoiceBlip::onGetData(Chunk& data) {
+    if (!samples){return false;}
+    //Tono: se lee el buffer a otra velocidad (interpolacion lineal, da la vuelta al final)
+    //Timbre: mezcla con un pasa bajos de un polo, hacia el (opaco) o alejandose (brillante)
+    for (size_t f = 0; f < ChunkFrames; ++f) {
+        size_t i0 = size_t(position);
+        size_t i1 = (i0 + 1 < frameCount) ? i0 + 1 : 0;
+        float frac = float(position - double(i0));
+        for (unsigned c = 0; c < channels; ++c) {
+            float a = samples[i0 * channels + c];
+            float b = samples[i1 * channels + c];
+            float s = a + (b - a) * frac;
+            lowpass[c] += 0.3f * (s - lowpass[c]);
+            float out = (timbre < 0.f) ? s + (-timbre) * (lowpass[c] - s) : s + timbre * (s - lowpass[c]);
+            if (out > 32767.f){out = 32767.f;}
+            if (out < -32768.f){out = -32768.f;}
+            chunk[f * channels + c] = static_cast<Int16>(out);
+        }
+        position += step;
+        while (position >= double(frameCount)) {
+            position -= double(frameCount);
+        }
+    }
+    data.samples = chunk.data();
+    data.sampleCount = chunk.size();
+    //Bucle infinito: el stream nunca termina solo
+    return true;
+}
+
+void VoiceBlip::onSeek(Time timeOffset) {
+    lowpass[0] = lowpass[1] = 0.f;
+    position = 0.0;
+    if (frameCount == 0){return;}
+    double frames = double(timeOffset.asSeconds()) * getSampleRate() * step;
+    position = fmod(frames, double(frameCount));
 }
@@ -2,17 +2,18 @@
 #define VOICEBLIP_H
 
 #include <SFML/Audio.hpp>
-#include <string>
-#include <memory>
+#include <vector>
 using namespace std;
 using namespace sf;
 
-class VoiceBlip {
+//Blip en bucle generado al vuelo desde un buffer compartido:
+//cambia tono y timbre por personaje sin copiar muestras
+class VoiceBlip : private SoundStream {
 public:
     VoiceBlip();
     ~VoiceBlip();
-    //Carga un archivo .wav/.ogg.
-    bool loadFromFile(const string& path);
+    //Buffer del VoiceBank (tiene que vivir mas que el blip) + variante del personaje
+    void setVoice(const SoundBuffer* base, float pitch, float timbre);
     //Reproduce el blip en bucle
     void playLoop();
     //Detiene la reproduccion
@@ -22,9 +23,17 @@ public:
     //Esta sonando actualmente?
     bool isPlaying() const;
 private:
-    //Usamos unique_ptr para gestionar el buffer en heap
-    unique_ptr<SoundBuffer> buffer;
-    Sound sound;
+    //Lo llama el hilo del stream; setVoice detiene antes de tocar estos campos
+    const Int16* samples;
+    size_t frameCount;
+    unsigned channels;
+    double position;
+    float step;
+    float timbre;
+    float lowpass[2];
+    vector<Int16> chunk;
+    bool onGetData(Chunk& data) override;
+    void onSeek(Time timeOffset) override;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,59 @@
+// AssetPacker.cpp - Remoria
+//Empaqueta assets/ y data/ en un solo .rpak que el juego mapea al iniciar
+//g++ -std=c++17 -O2 tools/AssetPacker.cpp src/core/AssetPack.cpp src/core/MappedFile.cpp src/core/ResourceId.cpp src/core/StringPool.cpp src/core/Arena.cpp -o AssetPacker
+#include <iostream>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include "../src/core/AssetPack.h"
+using namespace std;
+namespace fs = std::filesystem;
+
+int main(int argc, char** argv) {
+    string output = argc > 1 ? argv[1] : "Remoria.rpak";
+    vector<string> dirs;
+    for (int i = 2; i < argc; ++i) {
+        dirs.push_back(argv[i]);
+    }
+    if (dirs.empty()) {
+        dirs = { "assets", "data" };
+    }
+    vector<string> files;
+    uint64_t total = 0;
+    for (const auto& dir : dirs) {
+        error_code ec;
+        if (!fs::is_directory(dir, ec)) {
+            cerr << "[AssetPacker] No existe la carpeta: " << dir << endl;
+            return 1;
+        }
+        for (const auto& entry : fs::recursive_directory_iterator(dir)) {
+            if (!entry.is_regular_file()){continue;}
+            //El guardado es del jugador, no un asset
+            if (entry.path().filename() == "autosave.json"){continue;}
+            files.push_back(entry.path().generic_string());
+            total += entry.file_size();
+        }
+    }
+    if (!AssetPack::write(output, files)) {
+        cerr << "[AssetPacker] ERROR al escribir " << output << endl;
+        return 1;
+    }
+    //Verificar que cada archivo se encuentra en el pack recien escrito
+    AssetPack& pack = AssetPack::getInstance();
+    if (!pack.open(output, {})) {
+        cerr << "[AssetPacker] ERROR: no se pudo abrir " << output << endl;
+        return 1;
+    }
+    int missing = 0;
+    for (const auto& f : files) {
+        const char* data = nullptr;
+        size_t size = 0;
+        if (!pack.find(ResourceId::of(f), data, size) || size != fs::file_size(f)) {
+            cerr << "[AssetPacker] ERROR: falta en el pack: " << f << endl;
+            missing++;
+        }
+    }
+    cout << "[AssetPacker] " << files.size() << " archivos (" << total / 1024 << " KB) -> "
+         << output << " (" << fs::file_size(output) / 1024 << " KB)" << endl;
+    return missing == 0 ? 0 : 1;
+}
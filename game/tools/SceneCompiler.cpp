@@ -0,0 +1,42 @@
+// SceneCompiler.cpp - Remoria
+//Compila data/scenes/*.json a .scnb para las builds
+//g++ -std=c++17 -O2 tools/SceneCompiler.cpp src/visualnovel/SceneLoader.cpp src/visualnovel/SceneData.cpp src/core/MappedFile.cpp src/core/StringPool.cpp src/core/Arena.cpp src/core/AssetPack.cpp src/core/ResourceId.cpp -o SceneCompiler
+#include <iostream>
+#include <filesystem>
+#include "../src/visualnovel/SceneLoader.h"
+using namespace std;
+namespace fs = std::filesystem;
+
+int main(int argc, char** argv) {
+    string dir = argc > 1 ? argv[1] : "data/scenes";
+    error_code ec;
+    if (!fs::is_directory(dir, ec)) {
+        cerr << "[SceneCompiler] No existe la carpeta: " << dir << endl;
+        return 1;
+    }
+    int compiled = 0;
+    int failed = 0;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".json"){continue;}
+        string jsonPath = entry.path().generic_string();
+        string binPath = SceneLoader::binaryPathFor(jsonPath);
+        SceneData data;
+        if (!SceneLoader::loadJson(jsonPath, data) || !SceneLoader::writeBinary(binPath, data)) {
+            cerr << "[SceneCompiler] ERROR: " << jsonPath << endl;
+            failed++;
+            continue;
+        }
+        //Verificar que el binario se lee igual que el JSON
+        SceneData check;
+        if (!SceneLoader::loadBinary(binPath, check) || check.steps.size() != data.steps.size()) {
+            cerr << "[SceneCompiler] ERROR: verificacion fallida en " << binPath << endl;
+            failed++;
+            continue;
+        }
+        cout << "[SceneCompiler] " << jsonPath << " -> " << binPath
+             << " (" << data.steps.size() << " steps, " << fs::file_size(binPath) << " bytes)" << endl;
+        compiled++;
+    }
+    cout << "[SceneCompiler] " << compiled << " escenas compiladas, " << failed << " con errores" << endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+// SceneParseBench.cpp - Remoria
+//Compara el parse de escenas viejo (DOM + copia de "steps" + item.value) con el SAX de SceneLoader
+//Mide tiempo, pico de heap y cantidad de reservas por carga
+//g++ -std=c++17 -O2 tools/SceneParseBench.cpp src/visualnovel/SceneLoader.cpp src/visualnovel/SceneData.cpp src/core/MappedFile.cpp src/core/StringPool.cpp src/core/Arena.cpp src/core/AssetPack.cpp src/core/ResourceId.cpp -o SceneParseBench
+//Uso: SceneParseBench [iteraciones] [escena.json ...]   (sin escenas usa las 3 mas grandes de data/scenes)
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include "../src/visualnovel/SceneLoader.h"
+#include "../src/visualnovel/json.hpp"
+using namespace std;
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+//Contador de heap: cada bloque guarda su tamaño delante
+namespace {
+size_t heapCurrent = 0;
+size_t heapPeak = 0;
+size_t heapAllocs = 0;
+const size_t HeapHeader = 16;
+}
+
+void* operator new(size_t n) {
+    char* block = static_cast<char*>(malloc(n + HeapHeader));
+    if (!block){throw bad_alloc();}
+    *reinterpret_cast<size_t*>(block) = n;
+    heapCurrent += n;
+    heapAllocs++;
+    if (heapCurrent > heapPeak){heapPeak = heapCurrent;}
+    return block + HeapHeader;
+}
+
+void operator delete(void* p) noexcept {
+    if (!p){return;}
+    char* block = static_cast<char*>(p) - HeapHeader;
+    heapCurrent -= *reinterpret_cast<size_t*>(block);
+    free(block);
+}
+
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+namespace {
+//El SceneStep de antes: todo como string
+struct LegacyStep {
+    string type;
+    string speaker;
+    string text;
+    string bg_path;
+    string music_path;
+    string sfx_path;
+    float sfx_volume;
+    string effect;
+    float duration;
+    string goto_scene;
+    struct Choice {
+        string text;
+        string goto_scene;
+        int goto_step = -1;
+        string flag;
+        string require_flag;
+    };
+    vector<Choice> choices;
+};
+
+//Mismo camino que tenia Scene::loadFromFile (sin los cout de debug de las choices)
+bool legacyLoad(const string& path, vector<LegacyStep>& steps) {
+    ifstream f(path, ios::binary);
+    if (!f.is_open()){return false;}
+    string content((istreambuf_iterator<char>(f)), istreambuf_iterator<char>());
+    f.close();
+    json j = json::parse(content);
+    steps.clear();
+    json arr = j.contains("steps") ? j["steps"] : j["sequence"];
+    for (auto& item : arr) {
+        LegacyStep s;
+        s.type = item.value("type", "dialogue");
+        if (s.type == "dialogue") {
+            s.speaker = item.value("speaker", "");
+            s.text = item.value("text", "");
+            if (item.contains("sfx")) {
+                s.sfx_path = item.value("sfx", "");
+                s.sfx_volume = item.value("sfx_volume", 100.0f);
+            }
+        } else if (s.type == "change_bg") {
+            s.bg_path = item.value("bg", "");
+            if (item.contains("music")){s.music_path = item.value("music", "");}
+        } else if (s.type == "goto") {
+            s.goto_scene = item.value("scene", "");
+        } else if (s.type == "choice") {
+            if (!item.contains("choices") || !item["choices"].is_array()){continue;}
+            for (auto& c : item["choices"]) {
+                LegacyStep::Choice ch;
+                ch.text = c.value("text", "");
+                if (c.contains("goto")) {
+                    ch.goto_scene = c["goto"].get<string>();
+                } else if (c.contains("next")) {
+                    ch.goto_scene = c["next"].get<string>();
+                }
+                if (c.contains("goto_step")){ch.goto_step = c["goto_step"].get<int>();}
+                if (c.contains("flag")){ch.flag = c["flag"].get<string>();}
+                if (c.contains("require_flag")){ch.require_flag = c["require_flag"].get<string>();}
+                s.choices.push_back(ch);
+            }
+        } else if (s.type == "play_sfx") {
+            s.sfx_path = item.value("sound", "");
+            if (s.sfx_path.empty()){s.sfx_path = item.value("sfx", "");}
+            s.sfx_volume = item.value("volume", 100.0f);
+        } else if (s.type == "transition") {
+            s.effect = item.value("effect", "fade");
+            s.duration = item.value("duration", 1.0f);
+        }
+        steps.push_back(s);
+    }
+    return true;
+}
+
+struct BenchResult {
+    double usPerLoad = 0;
+    size_t peakBytes = 0;
+    size_t allocs = 0;
+    size_t steps = 0;
+};
+
+template <typename LoadFn>
+BenchResult bench(int iterations, LoadFn load) {
+    BenchResult r;
+    //Pico de una sola carga, medido aparte del cronometro
+    //La primera carga llena la NameTable; se mide la segunda, como al volver a una escena
+    load();
+    size_t base = heapCurrent;
+    heapPeak = heapCurrent;
+    size_t allocsBefore = heapAllocs;
+    r.steps = load();
+    r.peakBytes = heapPeak - base;
+    r.allocs = heapAllocs - allocsBefore;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        load();
+    }
+    r.usPerLoad = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / iterations;
+    return r;
+}
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? max(1, atoi(argv[1])) : 200;
+    vector<string> files;
+    for (int i = 2; i < argc; ++i) {
+        files.push_back(argv[i]);
+    }
+    error_code ec;
+    if (files.empty() && fs::is_directory("data/scenes", ec)) {
+        vector<pair<uintmax_t, string>> bySize;
+        for (const auto& entry : fs::recursive_directory_iterator("data/scenes")) {
+            if (entry.is_regular_file() && entry.path().extension() == ".json") {
+                bySize.push_back({ entry.file_size(), entry.path().generic_string() });
+            }
+        }
+        sort(bySize.rbegin(), bySize.rend());
+        for (size_t i = 0; i < bySize.size() && i < 3; ++i) {
+            files.push_back(bySize[i].second);
+        }
+    }
+    if (files.empty()) {
+        cerr << "[SceneParseBench] No hay escenas para medir" << endl;
+        return 1;
+    }
+    cout << "[SceneParseBench] Tamaño por step: SceneStep " << sizeof(SceneStep) << " bytes, antes "
+         << sizeof(LegacyStep) << " bytes + sus strings en el heap" << endl;
+    for (const auto& path : files) {
+        BenchResult legacy = bench(iterations, [&] {
+            vector<LegacyStep> steps;
+            legacyLoad(path, steps);
+            return steps.size();
+        });
+        BenchResult sax = bench(iterations, [&] {
+            SceneData data;
+            SceneLoader::loadJson(path, data);
+            return data.steps.size();
+        });
+        cout << "[SceneParseBench] " << path << " (" << fs::file_size(path, ec) << " bytes, " << sax.steps << " steps)" << endl;
+        cout << "  DOM: " << legacy.usPerLoad << " us/carga, pico " << legacy.peakBytes << " bytes, " << legacy.allocs << " allocs" << endl;
+        cout << "  SAX: " << sax.usPerLoad << " us/carga, pico " << sax.peakBytes << " bytes, " << sax.allocs << " allocs" << endl;
+        if (legacy.steps != sax.steps) {
+            cerr << "[SceneParseBench] ERROR: distinto numero de steps (" << legacy.steps << " vs " << sax.steps << ")" << endl;
+        }
+    }
+    return 0;
+}
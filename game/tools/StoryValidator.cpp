@@ -0,0 +1,213 @@
+// StoryValidator.cpp - Remoria
+//Valida toda la historia sin jugarla: carga data/scenes en paralelo y arma el grafo de escenas
+//g++ -std=c++17 -O2 -pthread tools/StoryValidator.cpp src/visualnovel/SceneLoader.cpp src/visualnovel/SceneData.cpp src/core/MappedFile.cpp src/core/StringPool.cpp src/core/Arena.cpp src/core/AssetPack.cpp src/core/ResourceId.cpp -o StoryValidator
+//Uso: StoryValidator [carpeta_escenas] [escena_inicial]
+#include <iostream>
+#include <filesystem>
+#include <vector>
+#include <map>
+#include <set>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include "../src/visualnovel/SceneLoader.h"
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+struct SceneReport {
+    string path;
+    bool loaded = false;
+    SceneData data;
+    //Destinos de goto y choices, ya normalizados
+    vector<string> targets;
+    vector<string> assets;
+    vector<string> errors;
+    vector<string> warnings;
+};
+
+string normalizePath(string_view path) {
+    return fs::path(resolveScenePath(path)).lexically_normal().generic_string();
+}
+
+void analyzeScene(SceneReport& r) {
+    r.loaded = SceneLoader::loadJson(r.path, r.data);
+    if (!r.loaded) {
+        r.errors.push_back("no se pudo cargar o parsear");
+        return;
+    }
+    const SceneData& d = r.data;
+    string dir = sceneDirOf(r.path);
+    auto addAsset = [&](string_view asset) {
+        if (!asset.empty()) {
+            r.assets.push_back(fs::path(resolveAssetPath(dir, asset)).lexically_normal().generic_string());
+        }
+    };
+    addAsset(d.header.bg);
+    if (d.header.hasMusic){addAsset(d.header.music);}
+    if (d.header.hasCharacter) {
+        addAsset(d.header.character.frame1);
+        addAsset(d.header.character.frame2);
+    }
+    for (size_t i = 0; i < d.steps.size(); ++i) {
+        const SceneStep& s = d.steps[i];
+        string where = "step " + to_string(i) + ": ";
+        switch (s.op) {
+        case StepOp::Unknown:
+            r.warnings.push_back(where + "tipo de step desconocido, el juego se queda esperando input ahi");
+            break;
+        case StepOp::ChangeBg:
+            addAsset(d.str(s.changeBg.bg));
+            addAsset(d.str(s.changeBg.music));
+            break;
+        case StepOp::Dialogue:
+            addAsset(d.str(s.dialogue.sfx));
+            break;
+        case StepOp::PlaySfx:
+            addAsset(d.str(s.playSfx.sfx));
+            break;
+        case StepOp::Transition:
+            if (s.transition.effect == TransitionEffect::Unknown) {
+                r.warnings.push_back(where + "efecto de transicion desconocido: " + string(d.str(s.transition.effectName)));
+            }
+            break;
+        case StepOp::Goto:
+            if (!s.gotoScene.scene) {
+                r.errors.push_back(where + "goto sin escena");
+            } else {
+                r.targets.push_back(normalizePath(d.str(s.gotoScene.scene)));
+            }
+            break;
+        case StepOp::Choice:
+            for (uint32_t c = s.choice.first; c < s.choice.first + s.choice.count; ++c) {
+                const SceneStep::Choice& ch = d.choices[c];
+                if (ch.goto_scene) {
+                    r.targets.push_back(normalizePath(d.str(ch.goto_scene)));
+                } else if (ch.goto_step >= 0 && ch.goto_step >= (int)d.steps.size()) {
+                    r.errors.push_back(where + "goto_step " + to_string(ch.goto_step) + " fuera de rango (la escena tiene "
+                                       + to_string(d.steps.size()) + " steps)");
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+}
+
+int main(int argc, char** argv) {
+    auto start = chrono::steady_clock::now();
+    string dir = argc > 1 ? argv[1] : "data/scenes";
+    string startScene = normalizePath(argc > 2 ? argv[2] : "data/scenes/prologue.json");
+    error_code ec;
+    if (!fs::is_directory(dir, ec)) {
+        cerr << "[StoryValidator] No existe la carpeta: " << dir << endl;
+        return 1;
+    }
+    vector<string> paths;
+    for (const auto& entry : fs::recursive_directory_iterator(dir)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".json") {
+            paths.push_back(entry.path().lexically_normal().generic_string());
+        }
+    }
+    //SceneData no se mueve: los reports se crean una vez con su tamaño final
+    vector<SceneReport> reports(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        reports[i].path = paths[i];
+    }
+    //Cada hilo toma la siguiente escena libre
+    atomic<size_t> nextIndex(0);
+    unsigned workerCount = max(1u, min<unsigned>(thread::hardware_concurrency(), (unsigned)reports.size()));
+    vector<thread> workers;
+    for (unsigned w = 0; w < workerCount; ++w) {
+        workers.emplace_back([&] {
+            for (size_t i = nextIndex++; i < reports.size(); i = nextIndex++) {
+                analyzeScene(reports[i]);
+            }
+        });
+    }
+    for (auto& t : workers){t.join();}
+
+    //Grafo y datos globales
+    map<string, size_t> byPath;
+    set<string> flagsSet;
+    set<string> assets;
+    for (size_t i = 0; i < reports.size(); ++i) {
+        byPath[reports[i].path] = i;
+        const SceneData& d = reports[i].data;
+        for (const auto& ch : d.choices) {
+            if (ch.flag){flagsSet.insert(string(d.str(ch.flag)));}
+        }
+        assets.insert(reports[i].assets.begin(), reports[i].assets.end());
+    }
+    for (auto& r : reports) {
+        for (const auto& t : r.targets) {
+            if (!byPath.count(t)) {
+                r.errors.push_back("destino inexistente: " + t);
+            }
+        }
+        for (const auto& ch : r.data.choices) {
+            string required(r.data.str(ch.require_flag));
+            if (ch.require_flag && !flagsSet.count(required)) {
+                r.errors.push_back("require_flag '" + required + "' nunca lo activa ninguna choice");
+            }
+        }
+    }
+    //Assets: cada path unico se revisa una sola vez
+    set<string> missingAssets;
+    for (const auto& a : assets) {
+        if (!fs::exists(a, ec)){missingAssets.insert(a);}
+    }
+    for (auto& r : reports) {
+        for (const auto& a : r.assets) {
+            if (missingAssets.count(a)) {
+                r.errors.push_back("asset inexistente: " + a);
+            }
+        }
+    }
+    //Alcanzables desde la escena inicial
+    vector<bool> reached(reports.size(), false);
+    deque<size_t> pending;
+    if (byPath.count(startScene)) {
+        reached[byPath[startScene]] = true;
+        pending.push_back(byPath[startScene]);
+    } else {
+        cerr << "[StoryValidator] ERROR: escena inicial no encontrada: " << startScene << endl;
+    }
+    while (!pending.empty()) {
+        size_t i = pending.front();
+        pending.pop_front();
+        for (const auto& t : reports[i].targets) {
+            auto it = byPath.find(t);
+            if (it != byPath.end() && !reached[it->second]) {
+                reached[it->second] = true;
+                pending.push_back(it->second);
+            }
+        }
+    }
+    size_t errorCount = 0;
+    size_t warningCount = 0;
+    size_t edgeCount = 0;
+    for (size_t i = 0; i < reports.size(); ++i) {
+        SceneReport& r = reports[i];
+        if (!reached[i] && r.loaded) {
+            r.warnings.push_back("inalcanzable desde " + startScene);
+        }
+        edgeCount += r.targets.size();
+        for (const auto& e : r.errors) {
+            cout << "[StoryValidator] ERROR " << r.path << ": " << e << endl;
+        }
+        for (const auto& w : r.warnings) {
+            cout << "[StoryValidator] AVISO " << r.path << ": " << w << endl;
+        }
+        errorCount += r.errors.size();
+        warningCount += r.warnings.size();
+    }
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << "[StoryValidator] " << reports.size() << " escenas, " << edgeCount << " saltos, "
+         << assets.size() << " assets, " << errorCount << " errores, " << warningCount << " avisos ("
+         << workerCount << " hilos, " << ms << " ms)" << endl;
+    return errorCount == 0 ? 0 : 1;
+}
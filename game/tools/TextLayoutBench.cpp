@@ -0,0 +1,195 @@
+// TextLayoutBench.cpp - Remoria
+//Compara el corte de lineas viejo de DialogueBox (re-medir la linea entera con sf::Text por cada palabra)
+//con TextLayout (una pasada con los avances cacheados por fuente y tamaño)
+//g++ -std=c++17 -O2 tools/TextLayoutBench.cpp src/graphics/TextLayout.cpp src/graphics/GlyphAtlas.cpp src/graphics/GlyphWarmup.cpp src/core/MappedFile.cpp src/core/AtomicFile.cpp -lsfml-graphics -lsfml-window -lsfml-system -o TextLayoutBench
+//Uso: TextLayoutBench [iteraciones]   (textos de data/scenes + un texto sintetico de 10k caracteres)
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <locale>
+#include <codecvt>
+#include "../src/graphics/TextLayout.h"
+#include "../src/visualnovel/json.hpp"
+using namespace std;
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace {
+typedef chrono::steady_clock BenchClock;
+//Los mismos valores que la caja de dialogo del juego
+const unsigned BodySize = 26;
+const float MaxWidth = 1676.f;
+
+double msSince(BenchClock::time_point start) {
+    return chrono::duration<double, milli>(BenchClock::now() - start).count();
+}
+
+wstring toWide(const string& str) {
+    try {
+        wstring_convert<codecvt_utf8_utf16<wchar_t>> conv;
+        return conv.from_bytes(str);
+    } catch (...) {
+        return wstring(str.begin(), str.end());
+    }
+}
+
+float legacyMeasure(const Font& font, const string& utf8) {
+    Text tmp;
+    tmp.setFont(font);
+    tmp.setCharacterSize(BodySize);
+    tmp.setString(toWide(utf8));
+    return tmp.getLocalBounds().width;
+}
+
+size_t charBytes(unsigned char uc) {
+    if ((uc & 0xE0) == 0xC0) return 2;
+    if ((uc & 0xF0) == 0xE0) return 3;
+    if ((uc & 0xF8) == 0xF0) return 4;
+    return 1;
+}
+
+//Copia del buildPages anterior (sin el armado de paginas)
+size_t legacyBreak(const Font& font, const string& text) {
+    vector<string> words;
+    string token;
+    for (size_t i = 0; i < text.size();) {
+        char c = text[i];
+        if (c == '\n' || c == ' ') {
+            if (!token.empty()) { words.push_back(token); token.clear(); }
+            words.push_back(string(1, c));
+            ++i;
+        } else {
+            size_t n = charBytes(static_cast<unsigned char>(c));
+            for (size_t b = 0; b < n && i < text.size(); ++b, ++i) token.push_back(text[i]);
+        }
+    }
+    if (!token.empty()) words.push_back(token);
+    vector<string> lines;
+    string curLine;
+    for (size_t i = 0; i < words.size(); ++i) {
+        string w = words[i];
+        if (w == "\n") {
+            lines.push_back(curLine);
+            curLine.clear();
+        } else if (w == " ") {
+            if (!curLine.empty()) curLine.push_back(' ');
+        } else {
+            string trial = curLine;
+            if (!trial.empty()) trial.push_back(' ');
+            trial += w;
+            if (legacyMeasure(font, trial) <= MaxWidth) {
+                if (!curLine.empty()) curLine.push_back(' ');
+                curLine += w;
+            } else if (curLine.empty()) {
+                string piece;
+                for (size_t idx = 0; idx < w.size();) {
+                    size_t n = charBytes(static_cast<unsigned char>(w[idx]));
+                    string nextPiece = piece + w.substr(idx, n);
+                    if (legacyMeasure(font, nextPiece) > MaxWidth){break;}
+                    piece = nextPiece;
+                    idx += n;
+                }
+                if (piece.empty()) {
+                    lines.push_back(w);
+                } else {
+                    lines.push_back(piece);
+                    if (piece.size() < w.size()) words.insert(words.begin() + i + 1, w.substr(piece.size()));
+                }
+                curLine.clear();
+            } else {
+                lines.push_back(curLine);
+                curLine = w;
+            }
+        }
+    }
+    if (!curLine.empty()) lines.push_back(curLine);
+    return lines.size();
+}
+
+//Texto de prueba: frases en castellano con acentos, saltos de linea y algunas palabras enormes
+string syntheticText(size_t chars) {
+    const char* phrases[] = {
+        "¿Y si mañana todo vuelve a empezar? ",
+        "Elena miró por la ventana del salón, sin decir nada. ",
+        "Había olvidado el camino de regreso, pero no la canción. ",
+        "Anticonstitucionalmentesupercalifragilisticoespialidosoremoriano ",
+        "¡Corre! ",
+        "El reloj de la cocina marcaba las siete y cuarto.\n",
+    };
+    string out;
+    for (size_t i = 0; out.size() < chars; ++i) {
+        out += phrases[(i * 7) % 6];
+    }
+    return out;
+}
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? max(1, atoi(argv[1])) : 20;
+    Font font;
+    if (!font.loadFromFile("assets/fonts/default.ttf")) {
+        cerr << "No se pudo cargar assets/fonts/default.ttf" << endl;
+        return 1;
+    }
+    //Casos: el dialogo mas largo, todos los de la escena con mas texto en un parrafo y el sintetico
+    vector<pair<string, string>> cases;
+    string longest;
+    string paragraph;
+    string paragraphScene;
+    error_code ec;
+    for (const auto& entry : fs::directory_iterator("data/scenes", ec)) {
+        if (entry.path().extension() != ".json"){continue;}
+        ifstream in(entry.path());
+        json doc = json::parse(in, nullptr, false);
+        if (doc.is_discarded() || !doc.contains("steps")){continue;}
+        string joined;
+        for (const auto& step : doc["steps"]) {
+            if (!step.contains("text") || !step["text"].is_string()){continue;}
+            string text = step["text"].get<string>();
+            if (text.size() > longest.size()){longest = text;}
+            if (!joined.empty()){joined += ' ';}
+            joined += text;
+        }
+        if (joined.size() > paragraph.size()) {
+            paragraph = joined;
+            paragraphScene = entry.path().filename().string();
+        }
+    }
+    if (!longest.empty()) {
+        cases.push_back(make_pair(string("dialogo mas largo"), longest));
+        cases.push_back(make_pair("parrafo " + paragraphScene, paragraph));
+    }
+    cases.push_back(make_pair(string("sintetico 10k"), syntheticText(10000)));
+
+    cout << fixed << setprecision(3);
+    cout << left << setw(36) << "texto" << right << setw(8) << "bytes" << setw(8) << "lineas"
+         << setw(12) << "viejo ms" << setw(12) << "nuevo ms" << setw(10) << "x" << endl;
+    GlyphMetrics& metrics = GlyphMetrics::get(font, BodySize);
+    vector<TextLine> lines;
+    for (const auto& c : cases) {
+        const string& text = c.second;
+        //El viejo es lento con 10k: menos vueltas alcanzan para medirlo
+        int legacyIterations = text.size() > 2000 ? 1 : iterations;
+        size_t legacyLines = 0;
+        auto start = BenchClock::now();
+        for (int i = 0; i < legacyIterations; ++i) {
+            legacyLines = legacyBreak(font, text);
+        }
+        double legacyMs = msSince(start) / legacyIterations;
+        start = BenchClock::now();
+        for (int i = 0; i < iterations; ++i) {
+            TextLayout::breakLines(text, &metrics, MaxWidth, lines);
+        }
+        double layoutMs = msSince(start) / iterations;
+        cout << left << setw(36) << c.first << right << setw(8) << text.size() << setw(8) << lines.size()
+             << setw(12) << legacyMs << setw(12) << layoutMs << setw(10) << (layoutMs > 0.0 ? legacyMs / layoutMs : 0.0) << endl;
+        if (legacyLines != lines.size()) {
+            cout << "  (el viejo da " << legacyLines << " lineas: duplicaba los espacios entre palabras)" << endl;
+        }
+    }
+    return 0;
+}
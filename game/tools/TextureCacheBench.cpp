@@ -0,0 +1,105 @@
+// TextureCacheBench.cpp - Remoria
+//Compara decodificar el png (camino de siempre) con mapear el blob RGBA de RawImageCache
+//Mide el tiempo por textura hasta tener los pixeles listos para Texture::update (sin GPU)
+//g++ -std=c++17 -O2 tools/TextureCacheBench.cpp src/core/RawImageCache.cpp src/core/AtomicFile.cpp src/core/MappedFile.cpp src/core/ResourceId.cpp src/core/StringPool.cpp src/core/Arena.cpp -lsfml-graphics -lsfml-system -o TextureCacheBench
+//Uso: TextureCacheBench [iteraciones] [imagen.png ...]   (sin imagenes usa assets/images/backgrounds)
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include "../src/core/RawImageCache.h"
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+typedef chrono::steady_clock BenchClock;
+
+double msSince(BenchClock::time_point start) {
+    return chrono::duration<double, milli>(BenchClock::now() - start).count();
+}
+
+//Lee todos los pixeles: la subida a la GPU tambien los recorre (y fuerza las paginas del mapeo)
+uint64_t touch(const Uint8* pixels, size_t bytes) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < bytes; i += 64) {
+        sum += pixels[i];
+    }
+    return sum;
+}
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? max(1, atoi(argv[1])) : 5;
+    vector<string> images;
+    for (int i = 2; i < argc; ++i) {
+        images.push_back(argv[i]);
+    }
+    if (images.empty()) {
+        error_code ec;
+        for (const auto& entry : fs::directory_iterator("assets/images/backgrounds", ec)) {
+            if (entry.path().extension() == ".png") {
+                images.push_back(entry.path().generic_string());
+            }
+        }
+        sort(images.begin(), images.end());
+    }
+    if (images.empty()) {
+        cerr << "No hay imagenes para medir" << endl;
+        return 1;
+    }
+    RawImageCache cache;
+    if (!cache.setDirectory("cache/bench")) {
+        return 1;
+    }
+    cout << fixed << setprecision(2);
+    cout << left << setw(44) << "imagen" << right << setw(12) << "png ms" << setw(12) << "raw ms" << setw(10) << "x" << endl;
+    double totalPng = 0.0;
+    double totalRaw = 0.0;
+    uint64_t sink = 0;
+    for (const auto& path : images) {
+        ResourceId id = ResourceId::of(path);
+        MappedFile png;
+        if (!png.open(path)) {
+            cerr << "No se pudo abrir " << path << endl;
+            continue;
+        }
+        uint64_t hash = RawImageCache::contentHash(png.data(), png.size());
+        //Camino actual: inflar el png en cada carga
+        double pngMs = 0.0;
+        Image image;
+        for (int i = 0; i < iterations; ++i) {
+            auto start = BenchClock::now();
+            image.loadFromMemory(png.data(), png.size());
+            sink += touch(image.getPixelsPtr(), size_t(image.getSize().x) * image.getSize().y * 4);
+            pngMs += msSince(start);
+        }
+        if (!cache.store(id, 0, hash, image, 1)) {
+            cerr << "No se pudo escribir el blob de " << path << endl;
+            continue;
+        }
+        //Con cache: hash del png (para validar) + mapear el blob
+        double rawMs = 0.0;
+        for (int i = 0; i < iterations; ++i) {
+            auto start = BenchClock::now();
+            RawImage raw;
+            if (cache.load(id, 0, RawImageCache::contentHash(png.data(), png.size()), raw)) {
+                sink += touch(raw.pixels, size_t(raw.size.x) * raw.size.y * 4);
+            }
+            rawMs += msSince(start);
+        }
+        pngMs /= iterations;
+        rawMs /= iterations;
+        totalPng += pngMs;
+        totalRaw += rawMs;
+        cout << left << setw(44) << fs::path(path).filename().string() << right << setw(12) << pngMs
+             << setw(12) << rawMs << setw(10) << (rawMs > 0.0 ? pngMs / rawMs : 0.0) << endl;
+    }
+    cout << left << setw(44) << "total" << right << setw(12) << totalPng << setw(12) << totalRaw
+         << setw(10) << (totalRaw > 0.0 ? totalPng / totalRaw : 0.0) << endl;
+    //Que el compilador no descarte las lecturas
+    volatile uint64_t keep = sink;
+    (void)keep;
+    return 0;
+}